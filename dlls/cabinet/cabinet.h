@@ -137,6 +137,12 @@ struct Ziphuft {
   } v;
 };
 
+/* two literals decoded with a single lookup, b == 0 if not possible */
+struct Zippair {
+  cab_UBYTE b;                /* total number of bits of both codes */
+  cab_UBYTE n[2];             /* the literals */
+};
+
 struct ZIPstate {
     cab_ULONG window_posn;      /* current offset within the window        */
     cab_ULONG bb;               /* bit buffer */
@@ -147,6 +153,7 @@ struct ZIPstate {
     struct Ziphuft *u[ZIPBMAX];	/* table stack */
     cab_ULONG v[ZIPN_MAX];      /* values in order of bit length */
     cab_ULONG x[ZIPBMAX+1];     /* bit offsets, then code stack */
+    struct Zippair pairs[1 << ZIPLBITS]; /* literal pairs for the current table */
     cab_UBYTE *inpos;
 };
   
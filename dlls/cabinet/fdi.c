@@ -857,6 +857,21 @@ static int NONEfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
   return DECR_OK;
 }
 
+/****************************************************
+ * fdi_copy_match (internal)
+ *
+ * Copy a match within the window. When the source overlaps the
+ * destination the bytes have to be copied one at a time so that the
+ * repeated pattern gets replicated.
+ */
+static inline void fdi_copy_match(cab_UBYTE *dest, const cab_UBYTE *src, cab_ULONG len)
+{
+  if (src > dest || (cab_ULONG)(dest - src) >= len)
+    memmove(dest, src, len);
+  else
+    while (len--) *dest++ = *src++;
+}
+
 /********************************************************
  * Ziphuft_free (internal)
  */
@@ -1055,6 +1070,35 @@ struct Ziphuft **t, cab_LONG *m, fdi_decomp_state *decomp_state)
   return y != 0 && g != 1;
 }
 
+/*********************************************************
+ * fdi_Zipbuild_pairs (internal)
+ *
+ * Find the entries of the base literal/length table whose bl bits hold
+ * two complete literal codes, so that runs of literals can be decoded
+ * two at a time.
+ */
+static void fdi_Zipbuild_pairs(const struct Ziphuft *tl, cab_LONG bl, fdi_decomp_state *decomp_state)
+{
+  struct Zippair *p = ZIP(pairs);
+  const struct Ziphuft *t, *t2;
+  cab_ULONG i, n = 1 << bl;
+
+  for (i = 0; i < n; i++, p++)
+  {
+    p->b = 0;
+    t = tl + i;
+    if (t->e != 16 || t->b >= bl)
+      continue;
+    /* the second code is known if it fits in the remaining bits */
+    t2 = tl + (i >> t->b);
+    if (t2->e != 16 || t->b + t2->b > bl)
+      continue;
+    p->b = t->b + t2->b;
+    p->n[0] = (cab_UBYTE)t->v.n;
+    p->n[1] = (cab_UBYTE)t2->v.n;
+  }
+}
+
 /*********************************************************
  * fdi_Zipinflate_codes (internal)
  */
@@ -1065,9 +1109,11 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
   cab_ULONG n, d;           /* length and index for copy */
   cab_ULONG w;              /* current window position */
   const struct Ziphuft *t;  /* pointer to table entry */
+  const struct Zippair *p;  /* pointer to literal pair entry */
   cab_ULONG ml, md;         /* masks for bl and bd bits */
   register cab_ULONG b;     /* bit buffer */
   register cab_ULONG k;     /* number of bits in bit buffer */
+  BOOL pairs;               /* literal pair table available */
 
   /* make local copies of globals */
   b = ZIP(bb);                       /* initialize bit buffer */
@@ -1078,9 +1124,19 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
   ml = Zipmask[bl];           	/* precompute masks for speed */
   md = Zipmask[bd];
 
+  if ((pairs = (bl <= ZIPLBITS)))
+    fdi_Zipbuild_pairs(tl, bl, decomp_state);
+
   for(;;)
   {
     ZIPNEEDBITS((cab_ULONG)bl)
+    if (pairs && (p = ZIP(pairs) + (b & ml))->b)
+    {
+      CAB(outbuf)[w++] = p->n[0];
+      CAB(outbuf)[w++] = p->n[1];
+      ZIPDUMPBITS(p->b)
+      continue;
+    }
     if((e = (t = tl + (b & ml))->e) > 16)
       do
       {
@@ -1124,10 +1180,9 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
         e = ZIPWSIZE - max(d, w);
         e = min(e, n);
         n -= e;
-        do
-        {
-          CAB(outbuf)[w++] = CAB(outbuf)[d++];
-        } while (--e);
+        fdi_copy_match(CAB(outbuf) + w, CAB(outbuf) + d, e);
+        w += e;
+        d += e;
       } while (n);
     }
   }
@@ -1530,14 +1585,15 @@ static int QTMfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
         if (copy_length < match_length) {
           match_length -= copy_length;
           window_posn += copy_length;
-          while (copy_length-- > 0) *rundest++ = *runsrc++;
+          fdi_copy_match(rundest, runsrc, copy_length);
+          rundest += copy_length;
           runsrc = window;
         }
       }
       window_posn += match_length;
 
       /* copy match data - no worries about destination wraps */
-      while (match_length-- > 0) *rundest++ = *runsrc++;
+      fdi_copy_match(rundest, runsrc, match_length);
     }
   } /* while (togo > 0) */
 
@@ -1768,14 +1824,15 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
               if (copy_length < match_length) {
                 match_length -= copy_length;
                 window_posn += copy_length;
-                while (copy_length-- > 0) *rundest++ = *runsrc++;
+                fdi_copy_match(rundest, runsrc, copy_length);
+                rundest += copy_length;
                 runsrc = window;
               }
             }
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
@@ -1857,14 +1914,15 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
               if (copy_length < match_length) {
                 match_length -= copy_length;
                 window_posn += copy_length;
-                while (copy_length-- > 0) *rundest++ = *runsrc++;
+                fdi_copy_match(rundest, runsrc, copy_length);
+                rundest += copy_length;
                 runsrc = window;
               }
             }
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
@@ -116,6 +116,7 @@ void*    hash_table_iter_up(struct hash_table_iter* hti) DECLSPEC_HIDDEN;
 extern unsigned dbghelp_options DECLSPEC_HIDDEN;
 /* some more Wine extensions */
 #define SYMOPT_WINE_WITH_NATIVE_MODULES 0x40000000
+#define SYMOPT_WINE_LAZY_DWARF          0x20000000  /* only parse dwarf compilation units when needed */
 
 enum location_kind {loc_error,          /* reg is the error code */
                     loc_unavailable,    /* location is not available */
@@ -618,6 +619,7 @@ extern struct module*
                     module_is_already_loaded(const struct process* pcs,
                                              const WCHAR* imgname) DECLSPEC_HIDDEN;
 extern BOOL         module_get_debug(struct module_pair*) DECLSPEC_HIDDEN;
+extern BOOL         module_get_debug_at(struct module_pair*, DWORD64 addr) DECLSPEC_HIDDEN;
 extern struct module*
                     module_new(struct process* pcs, const WCHAR* name,
                                enum module_type type, BOOL virtual,
@@ -686,6 +688,11 @@ extern BOOL         dwarf2_parse(struct module* module, unsigned long load_offse
                                  struct image_file_map* fmap) DECLSPEC_HIDDEN;
 extern BOOL         dwarf2_virtual_unwind(struct cpu_stack_walk* csw, DWORD_PTR ip,
                                           CONTEXT* context, ULONG_PTR* cfa) DECLSPEC_HIDDEN;
+extern void         dwarf2_load_units_at(struct module* module, DWORD_PTR addr) DECLSPEC_HIDDEN;
+extern void         dwarf2_load_all_units(struct module* module) DECLSPEC_HIDDEN;
+extern BOOL         dwarf2_defer_symbol(struct module* module, struct symt_compiland* compiland,
+                                        const char* name, BOOL is_function, BOOL is_local,
+                                        unsigned long address, unsigned long size) DECLSPEC_HIDDEN;
 
 /* stack.c */
 extern BOOL         sw_read_mem(struct cpu_stack_walk* csw, DWORD64 addr, void* ptr, DWORD sz) DECLSPEC_HIDDEN;
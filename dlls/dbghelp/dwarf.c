@@ -200,6 +200,48 @@ typedef struct dwarf2_parse_context_s
     char*                       cpp_name;
 } dwarf2_parse_context_t;
 
+/* compilation unit which parsing is delayed until it's needed */
+struct dwarf2_lazy_unit
+{
+    const unsigned char*        start;          /* unit header in .debug_info */
+    BOOL                        parsed;
+    BOOL                        indexed;        /* has at least one address range */
+    struct vector               pending;        /* symbols to add once the unit is parsed */
+};
+
+/* address range covered by a delayed compilation unit */
+struct dwarf2_lazy_range
+{
+    unsigned long               low;
+    unsigned long               high;
+    unsigned long               max_high;       /* highest end of this range and the previous ones */
+    unsigned                    unit;
+};
+
+/* symbol from the ELF symbol table falling into a not yet parsed unit */
+struct dwarf2_pending_symbol
+{
+    struct symt_compiland*      compiland;
+    const char*                 name;
+    unsigned long               address;
+    unsigned long               size;
+    BOOL                        is_function;
+    BOOL                        is_local;
+};
+
+struct dwarf2_lazy_info
+{
+    dwarf2_section_t            sections[section_max];
+    const struct elf_thunk_area*thunks;
+    unsigned long               load_offset;
+    unsigned                    num_units;
+    unsigned                    num_unparsed;
+    struct dwarf2_lazy_unit*    units;
+    unsigned                    num_ranges;
+    unsigned                    max_ranges;
+    struct dwarf2_lazy_range*   ranges;
+};
+
 /* stored in the dbghelp's module internal structure for later reuse */
 struct dwarf2_module_info_s
 {
@@ -207,6 +249,7 @@ struct dwarf2_module_info_s
     dwarf2_section_t            debug_frame;
     dwarf2_section_t            eh_frame;
     unsigned char               word_size;
+    struct dwarf2_lazy_info*    lazy;           /* only set when units are parsed on demand */
 };
 
 #define loc_dwarf2_location_list        (loc_user + 0)
@@ -2468,6 +2511,380 @@ static BOOL dwarf2_parse_compilation_unit(const dwarf2_section_t* sections,
     return ret;
 }
 
+/******************************************************************
+ *		dwarf2_read_unit_range
+ *
+ * Gets the range of addresses covered by a compilation unit, only looking
+ * at its top level entry
+ */
+static BOOL dwarf2_read_unit_range(const dwarf2_section_t* sections, struct module* module,
+                                   const unsigned char* start,
+                                   unsigned long* low, unsigned long* high)
+{
+    dwarf2_parse_context_t      ctx;
+    dwarf2_traverse_context_t   abbrev_ctx, cu_ctx;
+    dwarf2_debug_info_t         di;
+    dwarf2_abbrev_entry_attr_t* attr;
+    unsigned long               cu_length, cu_abbrev_offset, entry_code;
+    unsigned                    i;
+    BOOL                        ret = FALSE;
+
+    cu_ctx.data = start;
+    cu_length = dwarf2_parse_u4(&cu_ctx);
+    cu_ctx.end_data = cu_ctx.data + cu_length;
+    if (dwarf2_parse_u2(&cu_ctx) != 2) return FALSE;
+    cu_abbrev_offset = dwarf2_parse_u4(&cu_ctx);
+    cu_ctx.word_size = dwarf2_parse_byte(&cu_ctx);
+    module->format_info[DFI_DWARF]->u.dwarf2_info->word_size = cu_ctx.word_size;
+
+    pool_init(&ctx.pool, 4096);
+    ctx.sections = sections;
+    ctx.section = section_debug;
+    ctx.module = module;
+    ctx.ref_offset = start - sections[section_debug].address;
+    sparse_array_init(&ctx.debug_info_table, sizeof(dwarf2_debug_info_t), 4);
+
+    abbrev_ctx.data = sections[section_abbrev].address + cu_abbrev_offset;
+    abbrev_ctx.end_data = sections[section_abbrev].address + sections[section_abbrev].size;
+    abbrev_ctx.word_size = cu_ctx.word_size;
+    dwarf2_parse_abbrev_set(&abbrev_ctx, &ctx.abbrev_table, &ctx.pool);
+
+    entry_code = dwarf2_leb128_as_unsigned(&cu_ctx);
+    if (entry_code && (di.abbrev = dwarf2_abbrev_table_find_entry(&ctx.abbrev_table, entry_code)) &&
+        di.abbrev->tag == DW_TAG_compile_unit)
+    {
+        di.symt = NULL;
+        di.parent = NULL;
+        di.data = pool_alloc(&ctx.pool, (di.abbrev->num_attr + 1) * sizeof(const char*));
+        for (i = 0, attr = di.abbrev->attrs; attr; i++, attr = attr->next)
+        {
+            di.data[i] = cu_ctx.data;
+            dwarf2_swallow_attribute(&cu_ctx, attr);
+        }
+        ret = dwarf2_read_range(&ctx, &di, low, high);
+    }
+    pool_destroy(&ctx.pool);
+    return ret;
+}
+
+static int dwarf2_lazy_unit_cmp(const void* p1, const void* p2)
+{
+    const unsigned char* start = p1;
+    const struct dwarf2_lazy_unit* unit = p2;
+
+    if (start < unit->start) return -1;
+    return start > unit->start;
+}
+
+static int dwarf2_lazy_range_cmp(const void* p1, const void* p2)
+{
+    const struct dwarf2_lazy_range* r1 = p1;
+    const struct dwarf2_lazy_range* r2 = p2;
+
+    if (r1->low < r2->low) return -1;
+    return r1->low > r2->low;
+}
+
+static void dwarf2_lazy_add_range(struct dwarf2_lazy_info* lazy, unsigned unit,
+                                  unsigned long low, unsigned long high)
+{
+    struct dwarf2_lazy_range* new;
+
+    if (low >= high) return;
+    if (lazy->num_ranges == lazy->max_ranges)
+    {
+        unsigned new_max = max(64, lazy->max_ranges * 2);
+
+        if (lazy->ranges)
+            new = HeapReAlloc(GetProcessHeap(), 0, lazy->ranges, new_max * sizeof(*new));
+        else
+            new = HeapAlloc(GetProcessHeap(), 0, new_max * sizeof(*new));
+        if (!new) return;
+        lazy->ranges = new;
+        lazy->max_ranges = new_max;
+    }
+    new = &lazy->ranges[lazy->num_ranges++];
+    new->low  = lazy->load_offset + low;
+    new->high = lazy->load_offset + high;
+    new->unit = unit;
+    lazy->units[unit].indexed = TRUE;
+}
+
+/******************************************************************
+ *		dwarf2_lazy_read_aranges
+ *
+ * Fills the address index from the .debug_aranges section
+ */
+static void dwarf2_lazy_read_aranges(struct dwarf2_lazy_info* lazy, const dwarf2_section_t* aranges)
+{
+    dwarf2_traverse_context_t   ctx, set_ctx;
+    const unsigned char*        set_start;
+    const struct dwarf2_lazy_unit* unit;
+    unsigned long               length, offset, low, size;
+
+    ctx.data = aranges->address;
+    ctx.end_data = ctx.data + aranges->size;
+    while (ctx.data + 4 <= ctx.end_data)
+    {
+        set_start = ctx.data;
+        length = dwarf2_parse_u4(&ctx);
+        if (length == 0xffffffff || length > ctx.end_data - ctx.data) break;
+        set_ctx.data = ctx.data;
+        set_ctx.end_data = ctx.data + length;
+        ctx.data += length;
+
+        if (dwarf2_parse_u2(&set_ctx) != 2) continue;
+        offset = dwarf2_parse_u4(&set_ctx);
+        set_ctx.word_size = dwarf2_parse_byte(&set_ctx);
+        if (dwarf2_parse_byte(&set_ctx) || (set_ctx.word_size != 4 && set_ctx.word_size != 8))
+            continue; /* segmented addresses aren't supported */
+
+        unit = bsearch(lazy->sections[section_debug].address + offset, lazy->units,
+                       lazy->num_units, sizeof(*lazy->units), dwarf2_lazy_unit_cmp);
+        if (!unit)
+        {
+            WARN("no unit at offset 0x%lx\n", offset);
+            continue;
+        }
+        /* tuples are aligned on twice the address size from the start of the set */
+        set_ctx.data = set_start + (((set_ctx.data - set_start) + 2 * set_ctx.word_size - 1) &
+                                    ~(2 * set_ctx.word_size - 1));
+        while (set_ctx.data + 2 * set_ctx.word_size <= set_ctx.end_data)
+        {
+            low = dwarf2_parse_addr(&set_ctx);
+            size = dwarf2_parse_addr(&set_ctx);
+            if (!low && !size) break;
+            dwarf2_lazy_add_range(lazy, unit - lazy->units, low, low + size);
+        }
+    }
+}
+
+/******************************************************************
+ *		dwarf2_lazy_parse_unit
+ *
+ * Parses a delayed compilation unit
+ */
+static void dwarf2_lazy_parse_unit(struct module* module, struct dwarf2_lazy_info* lazy, unsigned idx)
+{
+    struct dwarf2_module_info_s* dwarf2_info = module->format_info[DFI_DWARF]->u.dwarf2_info;
+    dwarf2_traverse_context_t   mod_ctx;
+    unsigned char               word_size = dwarf2_info->word_size;
+
+    if (lazy->units[idx].parsed) return;
+    TRACE("parsing unit at 0x%x in %s\n",
+          (int)(lazy->units[idx].start - lazy->sections[section_debug].address),
+          debugstr_w(module->module.ModuleName));
+    lazy->units[idx].parsed = TRUE;
+    lazy->num_unparsed--;
+
+    mod_ctx.data = lazy->units[idx].start;
+    mod_ctx.end_data = lazy->sections[section_debug].address + lazy->sections[section_debug].size;
+    mod_ctx.word_size = 0;
+    dwarf2_parse_compilation_unit(lazy->sections, module, lazy->thunks, &mod_ctx, lazy->load_offset);
+    /* eh_frame parsing relies on the word size from the image */
+    dwarf2_info->word_size = word_size;
+}
+
+/******************************************************************
+ *		dwarf2_lazy_add_pending
+ *
+ * Creates the symbols from the ELF symbol table falling into a unit
+ * which has just been parsed, unless the unit already defined them
+ * (public symbols don't count)
+ */
+static void dwarf2_lazy_add_pending(struct module* module, struct dwarf2_lazy_unit* unit)
+{
+    struct dwarf2_pending_symbol* ps;
+    struct symt_ht*             symt;
+    struct location             loc;
+    ULONG64                     ref_addr;
+    unsigned                    i;
+
+    for (i = 0; i < vector_length(&unit->pending); i++)
+    {
+        ps = vector_at(&unit->pending, i);
+        symt = symt_find_nearest(module, ps->address);
+        if (symt && !symt_get_address(&symt->symt, &ref_addr))
+            ref_addr = ps->address;
+        if (symt && ps->address == ref_addr && symt->symt.tag != SymTagPublicSymbol) continue;
+
+        if (ps->is_function)
+            symt_new_function(module, ps->compiland, ps->name, ps->address, ps->size, NULL);
+        else
+        {
+            loc.kind = loc_absolute;
+            loc.reg = 0;
+            loc.offset = ps->address;
+            symt_new_global_variable(module, ps->compiland, ps->name, ps->is_local,
+                                     loc, ps->size, NULL);
+        }
+    }
+    vector_init(&unit->pending, sizeof(struct dwarf2_pending_symbol), 4);
+}
+
+/******************************************************************
+ *		dwarf2_load_units_at
+ *
+ * Makes sure all the compilation units covering an address have been parsed
+ */
+void dwarf2_load_units_at(struct module* module, DWORD_PTR addr)
+{
+    struct module_format*       modfmt = module->format_info[DFI_DWARF];
+    struct dwarf2_lazy_info*    lazy;
+    int                         low, high, mid, i;
+
+    if (!modfmt || !(lazy = modfmt->u.dwarf2_info->lazy) || !lazy->num_unparsed) return;
+
+    /* look for the last range starting at or before addr */
+    low = 0;
+    high = lazy->num_ranges;
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (lazy->ranges[mid].low <= addr) low = mid + 1;
+        else high = mid;
+    }
+    /* ranges may overlap, so go back while a previous range may still contain addr */
+    for (i = low - 1; i >= 0 && lazy->ranges[i].max_high > addr; i--)
+    {
+        if (addr < lazy->ranges[i].high)
+            dwarf2_lazy_parse_unit(module, lazy, lazy->ranges[i].unit);
+    }
+    for (i = low - 1; i >= 0 && lazy->ranges[i].max_high > addr; i--)
+    {
+        if (addr < lazy->ranges[i].high)
+            dwarf2_lazy_add_pending(module, &lazy->units[lazy->ranges[i].unit]);
+    }
+    module->module.NumSyms = module->ht_symbols.num_elts;
+}
+
+/******************************************************************
+ *		dwarf2_load_all_units
+ *
+ * Parses all the compilation units which haven't been parsed yet
+ */
+void dwarf2_load_all_units(struct module* module)
+{
+    struct module_format*       modfmt = module->format_info[DFI_DWARF];
+    struct dwarf2_lazy_info*    lazy;
+    unsigned                    i;
+
+    if (!modfmt || !(lazy = modfmt->u.dwarf2_info->lazy) || !lazy->num_unparsed) return;
+
+    TRACE("loading %u remaining units of %s\n", lazy->num_unparsed, debugstr_w(module->module.ModuleName));
+    for (i = 0; i < lazy->num_units; i++)
+        dwarf2_lazy_parse_unit(module, lazy, i);
+    for (i = 0; i < lazy->num_units; i++)
+        dwarf2_lazy_add_pending(module, &lazy->units[i]);
+    module->module.NumSyms = module->ht_symbols.num_elts;
+}
+
+/******************************************************************
+ *		dwarf2_defer_symbol
+ *
+ * Called for symbols of the ELF symbol table without debug information.
+ * If the symbol falls into a unit which hasn't been parsed yet, its creation
+ * is delayed until then, as the unit is likely to provide it.
+ */
+BOOL dwarf2_defer_symbol(struct module* module, struct symt_compiland* compiland,
+                         const char* name, BOOL is_function, BOOL is_local,
+                         unsigned long address, unsigned long size)
+{
+    struct module_format*       modfmt = module->format_info[DFI_DWARF];
+    struct dwarf2_lazy_info*    lazy;
+    struct dwarf2_pending_symbol* ps;
+    int                         low, high, mid, i;
+
+    if (!modfmt || !(lazy = modfmt->u.dwarf2_info->lazy) || !lazy->num_unparsed) return FALSE;
+
+    low = 0;
+    high = lazy->num_ranges;
+    while (low < high)
+    {
+        mid = (low + high) / 2;
+        if (lazy->ranges[mid].low <= address) low = mid + 1;
+        else high = mid;
+    }
+    for (i = low - 1; i >= 0 && lazy->ranges[i].max_high > address; i--)
+    {
+        struct dwarf2_lazy_unit* unit = &lazy->units[lazy->ranges[i].unit];
+
+        if (address >= lazy->ranges[i].high || unit->parsed) continue;
+        if (!(ps = vector_add(&unit->pending, &module->pool))) return FALSE;
+        ps->compiland   = compiland;
+        ps->name        = pool_strdup(&module->pool, name);
+        ps->address     = address;
+        ps->size        = size;
+        ps->is_function = is_function;
+        ps->is_local    = is_local;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/******************************************************************
+ *		dwarf2_lazy_index
+ *
+ * Builds the address index of the compilation units of a module, parsing only
+ * the units for which no address range can be found
+ */
+static BOOL dwarf2_lazy_index(struct module* module, struct dwarf2_lazy_info* lazy,
+                              const dwarf2_section_t* aranges)
+{
+    const dwarf2_section_t*     debug = &lazy->sections[section_debug];
+    dwarf2_traverse_context_t   mod_ctx;
+    unsigned long               length, low, high;
+    unsigned                    i, max_units = 0;
+
+    /* count the units */
+    mod_ctx.data = debug->address;
+    mod_ctx.end_data = debug->address + debug->size;
+    while (mod_ctx.data + 4 <= mod_ctx.end_data)
+    {
+        length = dwarf2_parse_u4(&mod_ctx);
+        mod_ctx.data += length;
+        max_units++;
+    }
+    if (!(lazy->units = HeapAlloc(GetProcessHeap(), 0, max_units * sizeof(*lazy->units))))
+        return FALSE;
+
+    mod_ctx.data = debug->address;
+    while (mod_ctx.data + 4 <= mod_ctx.end_data && lazy->num_units < max_units)
+    {
+        lazy->units[lazy->num_units].start = mod_ctx.data;
+        lazy->units[lazy->num_units].parsed = FALSE;
+        lazy->units[lazy->num_units].indexed = FALSE;
+        vector_init(&lazy->units[lazy->num_units].pending, sizeof(struct dwarf2_pending_symbol), 4);
+        lazy->num_units++;
+        length = dwarf2_parse_u4(&mod_ctx);
+        mod_ctx.data += length;
+    }
+    lazy->num_unparsed = lazy->num_units;
+
+    if (aranges->address && aranges->address != IMAGE_NO_MAP)
+        dwarf2_lazy_read_aranges(lazy, aranges);
+
+    for (i = 0; i < lazy->num_units; i++)
+    {
+        if (lazy->units[i].indexed) continue;
+        if (dwarf2_read_unit_range(lazy->sections, module, lazy->units[i].start, &low, &high))
+            dwarf2_lazy_add_range(lazy, i, low, high);
+        /* without any address, the unit can't be found later on, so parse it now */
+        if (!lazy->units[i].indexed) dwarf2_lazy_parse_unit(module, lazy, i);
+    }
+
+    qsort(lazy->ranges, lazy->num_ranges, sizeof(*lazy->ranges), dwarf2_lazy_range_cmp);
+    for (i = 0; i < lazy->num_ranges; i++)
+    {
+        lazy->ranges[i].max_high = lazy->ranges[i].high;
+        if (i && lazy->ranges[i - 1].max_high > lazy->ranges[i].max_high)
+            lazy->ranges[i].max_high = lazy->ranges[i - 1].max_high;
+    }
+    TRACE("%s: %u units, %u ranges, %u units parsed\n", debugstr_w(module->module.ModuleName),
+          lazy->num_units, lazy->num_ranges, lazy->num_units - lazy->num_unparsed);
+    return TRUE;
+}
+
 static BOOL dwarf2_lookup_loclist(const struct module_format* modfmt, const BYTE* start,
                                   unsigned long ip, dwarf2_traverse_context_t* lctx)
 {
@@ -3250,7 +3667,7 @@ BOOL dwarf2_virtual_unwind(struct cpu_stack_walk* csw, ULONG_PTR ip, CONTEXT* co
 
     if (!(pair.pcs = process_find_by_handle(csw->hProcess)) ||
         !(pair.requested = module_find_by_addr(pair.pcs, ip, DMT_UNKNOWN)) ||
-        !module_get_debug(&pair))
+        !module_get_debug_at(&pair, ip))
         return FALSE;
     modfmt = pair.effective->format_info[DFI_DWARF];
     if (!modfmt) return FALSE;
@@ -3491,6 +3908,17 @@ static inline void dwarf2_fini_section(dwarf2_section_t* section)
 
 static void dwarf2_module_remove(struct process* pcs, struct module_format* modfmt)
 {
+    struct dwarf2_lazy_info* lazy = modfmt->u.dwarf2_info->lazy;
+
+    if (lazy)
+    {
+        unsigned i;
+
+        for (i = 0; i < section_max; i++) dwarf2_fini_section(&lazy->sections[i]);
+        HeapFree(GetProcessHeap(), 0, lazy->units);
+        HeapFree(GetProcessHeap(), 0, lazy->ranges);
+        HeapFree(GetProcessHeap(), 0, lazy);
+    }
     dwarf2_fini_section(&modfmt->u.dwarf2_info->debug_loc);
     dwarf2_fini_section(&modfmt->u.dwarf2_info->debug_frame);
     HeapFree(GetProcessHeap(), 0, modfmt);
@@ -3506,6 +3934,7 @@ BOOL dwarf2_parse(struct module* module, unsigned long load_offset,
                                 debug_line_sect, debug_ranges_sect, eh_frame_sect;
     BOOL                ret = TRUE;
     struct module_format* dwarf2_modfmt;
+    struct dwarf2_lazy_info* lazy = NULL;
 
     dwarf2_init_section(&eh_frame,                fmap, ".eh_frame",     NULL,             &eh_frame_sect);
     dwarf2_init_section(&section[section_debug],  fmap, ".debug_info",   ".zdebug_info",   &debug_sect);
@@ -3549,6 +3978,7 @@ BOOL dwarf2_parse(struct module* module, unsigned long load_offset,
     dwarf2_modfmt->loc_compute = dwarf2_location_compute;
     dwarf2_modfmt->u.dwarf2_info = (struct dwarf2_module_info_s*)(dwarf2_modfmt + 1);
     dwarf2_modfmt->u.dwarf2_info->word_size = 0; /* will be correctly set later on */
+    dwarf2_modfmt->u.dwarf2_info->lazy = NULL;
     dwarf2_modfmt->module->format_info[DFI_DWARF] = dwarf2_modfmt;
 
     /* As we'll need later some sections' content, we won't unmap these
@@ -3558,9 +3988,41 @@ BOOL dwarf2_parse(struct module* module, unsigned long load_offset,
     dwarf2_init_section(&dwarf2_modfmt->u.dwarf2_info->debug_frame, fmap, ".debug_frame", ".zdebug_frame", NULL);
     dwarf2_modfmt->u.dwarf2_info->eh_frame = eh_frame;
 
-    while (mod_ctx.data < mod_ctx.end_data)
+    /* Only index the compilation units when asked to, they'll get parsed once
+     * an address inside them is looked up, or all at once for any other query.
+     * This requires the sections to stay mapped, which is only the case for ELF files.
+     */
+    if ((dbghelp_options & SYMOPT_WINE_LAZY_DWARF) && fmap->modtype == DMT_ELF &&
+        section[section_debug].address && section[section_debug].address != IMAGE_NO_MAP &&
+        (lazy = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*lazy))))
+    {
+        dwarf2_section_t aranges;
+        struct image_section_map aranges_sect;
+
+        memcpy(lazy->sections, section, sizeof(section));
+        lazy->thunks = thunks;
+        lazy->load_offset = load_offset;
+        dwarf2_modfmt->u.dwarf2_info->lazy = lazy;
+
+        dwarf2_init_section(&aranges, fmap, ".debug_aranges", ".zdebug_aranges", &aranges_sect);
+        if (!dwarf2_lazy_index(module, lazy, &aranges))
+        {
+            dwarf2_modfmt->u.dwarf2_info->lazy = NULL;
+            HeapFree(GetProcessHeap(), 0, lazy->units);
+            HeapFree(GetProcessHeap(), 0, lazy->ranges);
+            HeapFree(GetProcessHeap(), 0, lazy);
+            lazy = NULL;
+        }
+        else if (lazy->num_ranges) module->module.LineNumbers = TRUE;
+        dwarf2_fini_section(&aranges);
+        image_unmap_section(&aranges_sect);
+    }
+    if (!lazy)
     {
-        dwarf2_parse_compilation_unit(section, dwarf2_modfmt->module, thunks, &mod_ctx, load_offset);
+        while (mod_ctx.data < mod_ctx.end_data)
+        {
+            dwarf2_parse_compilation_unit(section, dwarf2_modfmt->module, thunks, &mod_ctx, load_offset);
+        }
     }
     dwarf2_modfmt->module->module.SymType = SymDia;
     dwarf2_modfmt->module->module.CVSig = 'D' | ('W' << 8) | ('A' << 16) | ('R' << 24);
@@ -3574,6 +4036,9 @@ BOOL dwarf2_parse(struct module* module, unsigned long load_offset,
     dwarf2_modfmt->u.dwarf2_info->word_size = fmap->addr_size / 8;
 
 leave:
+    /* the sections are still needed for parsing the remaining units */
+    if (lazy) return ret;
+
     dwarf2_fini_section(&section[section_debug]);
     dwarf2_fini_section(&section[section_abbrev]);
     dwarf2_fini_section(&section[section_string]);
@@ -131,12 +131,15 @@ struct elf_thunk_area
     unsigned long               rva_end;
 };
 
+#define MAX_THUNK_AREAS 7
+
 struct elf_module_info
 {
     unsigned long               elf_addr;
     unsigned short	        elf_mark : 1,
                                 elf_loader : 1;
     struct image_file_map       file_map;
+    struct elf_thunk_area       thunks[MAX_THUNK_AREAS]; /* kept for lazily parsed debug info */
 };
 
 /******************************************************************
@@ -866,6 +869,14 @@ static int elf_new_wine_thunks(struct module* module, const struct hash_table* h
             ULONG64     ref_addr;
             struct location loc;
 
+            if ((ELF32_ST_TYPE(ste->sym.st_info) == STT_FUNC ||
+                 ELF32_ST_TYPE(ste->sym.st_info) == STT_OBJECT) &&
+                dwarf2_defer_symbol(module, ste->compiland, ste->ht_elt.name,
+                                    ELF32_ST_TYPE(ste->sym.st_info) == STT_FUNC,
+                                    ELF32_ST_BIND(ste->sym.st_info) == STB_LOCAL,
+                                    addr, ste->sym.st_size))
+                continue;
+
             symt = symt_find_nearest(module, addr);
             if (symt && !symt_get_address(&symt->symt, &ref_addr))
                 ref_addr = addr;
@@ -1181,7 +1192,7 @@ static BOOL elf_load_debug_info_from_map(struct module* module,
                                          struct hash_table* ht_symtab)
 {
     BOOL                ret = FALSE, lret;
-    struct elf_thunk_area thunks[] = 
+    static const struct elf_thunk_area default_thunks[MAX_THUNK_AREAS] =
     {
         {"__wine_spec_import_thunks",           THUNK_ORDINAL_NOTYPE, 0, 0},    /* inter DLL calls */
         {"__wine_spec_delayed_import_loaders",  THUNK_ORDINAL_LOAD,   0, 0},    /* delayed inter DLL calls */
@@ -1191,7 +1202,9 @@ static BOOL elf_load_debug_info_from_map(struct module* module,
         {"__wine_spec_thunk_text_32",           -32,                  0, 0},    /* 32 => 16 thunks */
         {NULL,                                  0,                    0, 0}
     };
+    struct elf_thunk_area* thunks = module->format_info[DFI_ELF]->u.elf_info->thunks;
 
+    memcpy(thunks, default_thunks, sizeof(default_thunks));
     module->module.SymType = SymExport;
 
     /* create a hash table for the symtab */
@@ -964,7 +964,7 @@ static BOOL symt_enum_locals(struct process* pcs, const WCHAR* mask,
 
     pair.pcs = pcs;
     pair.requested = module_find_by_addr(pair.pcs, pc, DMT_UNKNOWN);
-    if (!module_get_debug(&pair)) return FALSE;
+    if (!module_get_debug_at(&pair, pc)) return FALSE;
     if ((sym = symt_find_nearest(pair.effective, pc)) == NULL) return FALSE;
 
     if (sym->symt.tag == SymTagFunction)
@@ -1030,12 +1030,11 @@ static BOOL sym_enum(HANDLE hProcess, ULONG64 BaseOfDll, PCWSTR Mask,
 
         for (pair.requested = pair.pcs->lmodules; pair.requested; pair.requested = pair.requested->next)
         {
-            if (pair.requested->type == DMT_PE && module_get_debug(&pair))
-            {
-                if (SymMatchStringW(pair.requested->module.ModuleName, mod, FALSE) &&
-                    symt_enum_module(&pair, bang + 1, se))
-                    break;
-            }
+            /* check the name first, so that the debug info of the other modules isn't loaded */
+            if (pair.requested->type == DMT_PE &&
+                SymMatchStringW(pair.requested->module.ModuleName, mod, FALSE) &&
+                module_get_debug(&pair) && symt_enum_module(&pair, bang + 1, se))
+                break;
         }
         /* not found in PE modules, retry on the ELF ones
          */
@@ -1045,12 +1044,9 @@ static BOOL sym_enum(HANDLE hProcess, ULONG64 BaseOfDll, PCWSTR Mask,
             {
                 if ((pair.requested->type == DMT_ELF || pair.requested->type == DMT_MACHO) &&
                     !module_get_containee(pair.pcs, pair.requested) &&
-                    module_get_debug(&pair))
-                {
-                    if (SymMatchStringW(pair.requested->module.ModuleName, mod, FALSE) &&
-                        symt_enum_module(&pair, bang + 1, se))
+                    SymMatchStringW(pair.requested->module.ModuleName, mod, FALSE) &&
+                    module_get_debug(&pair) && symt_enum_module(&pair, bang + 1, se))
                     break;
-                }
             }
         }
         HeapFree(GetProcessHeap(), 0, mod);
@@ -1224,7 +1220,7 @@ BOOL WINAPI SymFromAddr(HANDLE hProcess, DWORD64 Address,
     pair.pcs = process_find_by_handle(hProcess);
     if (!pair.pcs) return FALSE;
     pair.requested = module_find_by_addr(pair.pcs, Address, DMT_UNKNOWN);
-    if (!module_get_debug(&pair)) return FALSE;
+    if (!module_get_debug_at(&pair, Address)) return FALSE;
     if ((sym = symt_find_nearest(pair.effective, Address)) == NULL) return FALSE;
 
     symt_fill_sym_info(&pair, NULL, &sym->symt, Symbol);
@@ -1583,7 +1579,7 @@ BOOL WINAPI SymGetLineFromAddr64(HANDLE hProcess, DWORD64 dwAddr,
     pair.pcs = process_find_by_handle(hProcess);
     if (!pair.pcs) return FALSE;
     pair.requested = module_find_by_addr(pair.pcs, dwAddr, DMT_UNKNOWN);
-    if (!module_get_debug(&pair)) return FALSE;
+    if (!module_get_debug_at(&pair, dwAddr)) return FALSE;
     if ((symt = symt_find_nearest(pair.effective, dwAddr)) == NULL) return FALSE;
 
     if (symt->symt.tag != SymTagFunction) return FALSE;
@@ -1626,7 +1622,7 @@ BOOL WINAPI SymGetLinePrev64(HANDLE hProcess, PIMAGEHLP_LINE64 Line)
     pair.pcs = process_find_by_handle(hProcess);
     if (!pair.pcs) return FALSE;
     pair.requested = module_find_by_addr(pair.pcs, Line->Address, DMT_UNKNOWN);
-    if (!module_get_debug(&pair)) return FALSE;
+    if (!module_get_debug_at(&pair, Line->Address)) return FALSE;
 
     if (Line->Key == 0) return FALSE;
     li = Line->Key;
@@ -1709,7 +1705,7 @@ BOOL WINAPI SymGetLineNext64(HANDLE hProcess, PIMAGEHLP_LINE64 Line)
     pair.pcs = process_find_by_handle(hProcess);
     if (!pair.pcs) return FALSE;
     pair.requested = module_find_by_addr(pair.pcs, Line->Address, DMT_UNKNOWN);
-    if (!module_get_debug(&pair)) return FALSE;
+    if (!module_get_debug_at(&pair, Line->Address)) return FALSE;
 
     if (symt_get_func_line_next(pair.effective, Line)) return TRUE;
     SetLastError(ERROR_NO_MORE_ITEMS); /* FIXME */
@@ -906,7 +906,9 @@ BOOL WINAPI SymGetTypeInfo(HANDLE hProcess, DWORD64 ModBase,
     if (!pair.pcs) return FALSE;
 
     pair.requested = module_find_by_addr(pair.pcs, ModBase, DMT_UNKNOWN);
-    if (!module_get_debug(&pair))
+    /* TypeId comes from an already returned symbol, so lazily loaded debug info
+     * doesn't need to be completed */
+    if (!module_get_debug_at(&pair, ModBase))
     {
         FIXME("Someone didn't properly set ModBase (%s)\n", wine_dbgstr_longlong(ModBase));
         return FALSE;
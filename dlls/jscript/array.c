@@ -32,6 +32,16 @@ typedef struct {
     jsdisp_t dispex;
 
     DWORD length;
+
+    /*
+     * As long as the array has no holes, its elements [0, elems_cnt) are
+     * stored in elems. Once it becomes sparse, all elements are moved to
+     * the regular property map and elems stays unused.
+     */
+    jsval_t *elems;
+    DWORD elems_cnt;
+    DWORD elems_size;
+    BOOL sparse;
 } ArrayInstance;
 
 static const WCHAR lengthW[] = {'l','e','n','g','t','h',0};
@@ -66,6 +76,61 @@ static inline ArrayInstance *array_this(vdisp_t *jsthis)
     return is_vclass(jsthis, JSCLASS_ARRAY) ? array_from_vdisp(jsthis) : NULL;
 }
 
+/* Returns the array if all its elements are in dense storage. */
+static inline ArrayInstance *dense_array(jsdisp_t *jsdisp)
+{
+    ArrayInstance *array;
+
+    if(!is_class(jsdisp, JSCLASS_ARRAY))
+        return NULL;
+
+    array = array_from_jsdisp(jsdisp);
+    return !array->sparse && array->elems_cnt == array->length ? array : NULL;
+}
+
+static HRESULT array_reserve(ArrayInstance *array, DWORD size)
+{
+    jsval_t *new_elems;
+    DWORD new_size;
+
+    if(size <= array->elems_size)
+        return S_OK;
+
+    new_size = max(size, max(array->elems_size*2, 8));
+    new_elems = heap_realloc(array->elems, new_size*sizeof(*new_elems));
+    if(!new_elems)
+        return E_OUTOFMEMORY;
+
+    array->elems = new_elems;
+    array->elems_size = new_size;
+    return S_OK;
+}
+
+/* Moves all elements from dense storage to the property map. */
+static HRESULT array_make_sparse(ArrayInstance *array)
+{
+    jsval_t *elems = array->elems;
+    DWORD i, cnt = array->elems_cnt;
+    HRESULT hres = S_OK;
+
+    if(array->sparse)
+        return S_OK;
+
+    TRACE("%p: %u elements\n", array, cnt);
+
+    array->sparse = TRUE;
+    array->elems = NULL;
+    array->elems_cnt = array->elems_size = 0;
+
+    for(i=0; i < cnt; i++) {
+        if(SUCCEEDED(hres))
+            hres = jsdisp_propput_idx(&array->dispex, i, elems[i]);
+        jsval_release(elems[i]);
+    }
+    heap_free(elems);
+    return hres;
+}
+
 unsigned array_get_length(jsdisp_t *array)
 {
     assert(is_class(array, JSCLASS_ARRAY));
@@ -104,7 +169,11 @@ static HRESULT get_length(script_ctx_t *ctx, vdisp_t *vdisp, jsdisp_t **jsthis,
 static HRESULT set_length(jsdisp_t *obj, DWORD length)
 {
     if(is_class(obj, JSCLASS_ARRAY)) {
-        array_from_jsdisp(obj)->length = length;
+        ArrayInstance *array = array_from_jsdisp(obj);
+
+        while(array->elems_cnt > length)
+            jsval_release(array->elems[--array->elems_cnt]);
+        array->length = length;
         return S_OK;
     }
 
@@ -151,6 +220,13 @@ static HRESULT Array_set_length(script_ctx_t *ctx, jsdisp_t *jsthis, jsval_t val
     if(len!=(DWORD)len)
         return throw_range_error(ctx, JS_E_INVALID_LENGTH, NULL);
 
+    if(!This->sparse) {
+        while(This->elems_cnt > len)
+            jsval_release(This->elems[--This->elems_cnt]);
+        This->length = len;
+        return S_OK;
+    }
+
     for(i=len; i < This->length; i++) {
         hres = jsdisp_delete_idx(&This->dispex, i);
         if(FAILED(hres))
@@ -163,10 +239,27 @@ static HRESULT Array_set_length(script_ctx_t *ctx, jsdisp_t *jsthis, jsval_t val
 
 static HRESULT concat_array(jsdisp_t *array, ArrayInstance *obj, DWORD *len)
 {
+    ArrayInstance *dst;
     jsval_t val;
     DWORD i;
     HRESULT hres;
 
+    if(!obj->sparse && (dst = dense_array(array)) && dst->elems_cnt == *len) {
+        hres = array_reserve(dst, dst->elems_cnt + obj->elems_cnt);
+        if(FAILED(hres))
+            return hres;
+
+        for(i=0; i < obj->elems_cnt; i++) {
+            hres = jsval_copy(obj->elems[i], dst->elems+dst->elems_cnt);
+            if(FAILED(hres))
+                return hres;
+            dst->length = ++dst->elems_cnt;
+        }
+
+        *len += obj->length;
+        return S_OK;
+    }
+
     for(i=0; i < obj->length; i++) {
         hres = jsdisp_get_idx(&obj->dispex, i, &val);
         if(hres == DISP_E_UNKNOWNNAME)
@@ -413,6 +506,7 @@ static HRESULT Array_pop(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned
 static HRESULT Array_push(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *jsthis;
     DWORD length = 0;
     unsigned i;
@@ -424,6 +518,23 @@ static HRESULT Array_push(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigne
     if(FAILED(hres))
         return hres;
 
+    if((array = dense_array(jsthis))) {
+        hres = array_reserve(array, length+argc);
+        if(FAILED(hres))
+            return hres;
+
+        for(i=0; i < argc; i++) {
+            hres = jsval_copy(argv[i], array->elems+array->elems_cnt);
+            if(FAILED(hres))
+                return hres;
+            array->length = ++array->elems_cnt;
+        }
+
+        if(r)
+            *r = jsval_number(length+argc);
+        return S_OK;
+    }
+
     for(i=0; i < argc; i++) {
         hres = jsdisp_propput_idx(jsthis, length+i, argv[i]);
         if(FAILED(hres))
@@ -497,6 +608,7 @@ static HRESULT Array_reverse(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsi
 static HRESULT Array_shift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *jsthis;
     DWORD length = 0, i;
     jsval_t v, ret;
@@ -518,6 +630,18 @@ static HRESULT Array_shift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsign
         return S_OK;
     }
 
+    if((array = dense_array(jsthis))) {
+        ret = array->elems[0];
+        memmove(array->elems, array->elems+1, (length-1)*sizeof(*array->elems));
+        array->length = --array->elems_cnt;
+
+        if(r)
+            *r = ret;
+        else
+            jsval_release(ret);
+        return S_OK;
+    }
+
     hres = jsdisp_get_idx(jsthis, 0, &ret);
     if(hres == DISP_E_UNKNOWNNAME) {
         ret = jsval_undefined();
@@ -551,6 +675,7 @@ static HRESULT Array_shift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsign
 /* ECMA-262 3rd Edition    15.4.4.10 */
 static HRESULT Array_slice(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *arr, *jsthis;
     DOUBLE range;
     DWORD length, start, end, idx;
@@ -592,6 +717,27 @@ static HRESULT Array_slice(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsign
     if(FAILED(hres))
         return hres;
 
+    if((array = dense_array(jsthis)) && end > start) {
+        ArrayInstance *ret = array_from_jsdisp(arr);
+
+        hres = array_reserve(ret, end-start);
+        for(idx=start; SUCCEEDED(hres) && idx<end; idx++) {
+            hres = jsval_copy(array->elems[idx], ret->elems+ret->elems_cnt);
+            if(SUCCEEDED(hres))
+                ret->elems_cnt++;
+        }
+        if(FAILED(hres)) {
+            jsdisp_release(arr);
+            return hres;
+        }
+
+        if(r)
+            *r = jsval_obj(arr);
+        else
+            jsdisp_release(arr);
+        return S_OK;
+    }
+
     for(idx=start; idx<end; idx++) {
         jsval_t v;
 
@@ -673,6 +819,7 @@ static HRESULT sort_cmp(script_ctx_t *ctx, jsdisp_t *cmp_func, jsval_t v1, jsval
 static HRESULT Array_sort(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *jsthis, *cmp_func = NULL;
     jsval_t *vtab, **sorttab = NULL;
     DWORD length;
@@ -714,7 +861,13 @@ static HRESULT Array_sort(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigne
     }
 
     vtab = heap_alloc_zero(length * sizeof(*vtab));
-    if(vtab) {
+    if(vtab && (array = dense_array(jsthis))) {
+        for(i=0; i<length; i++) {
+            hres = jsval_copy(array->elems[i], vtab+i);
+            if(FAILED(hres))
+                break;
+        }
+    }else if(vtab) {
         for(i=0; i<length; i++) {
             hres = jsdisp_get_idx(jsthis, i, vtab+i);
             if(hres == DISP_E_UNKNOWNNAME) {
@@ -1006,6 +1159,7 @@ static HRESULT Array_indexOf(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsi
 static HRESULT Array_unshift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
+    ArrayInstance *array;
     jsdisp_t *jsthis;
     WCHAR buf[14], *buf_end, *str;
     DWORD i, length;
@@ -1019,6 +1173,29 @@ static HRESULT Array_unshift(script_ctx_t *ctx, vdisp_t *vthis, WORD flags, unsi
     if(FAILED(hres))
         return hres;
 
+    if(argc && (array = dense_array(jsthis))) {
+        hres = array_reserve(array, length+argc);
+        if(FAILED(hres))
+            return hres;
+
+        memmove(array->elems+argc, array->elems, array->elems_cnt*sizeof(*array->elems));
+        for(i=0; i < argc; i++) {
+            hres = jsval_copy(argv[i], array->elems+i);
+            if(FAILED(hres)) {
+                while(i--)
+                    jsval_release(array->elems[i]);
+                memmove(array->elems, array->elems+argc, array->elems_cnt*sizeof(*array->elems));
+                return hres;
+            }
+        }
+        array->elems_cnt += argc;
+        array->length = array->elems_cnt;
+
+        if(r)
+            *r = ctx->version < 2 ? jsval_undefined() : jsval_number(length+argc);
+        return S_OK;
+    }
+
     if(argc) {
         buf_end = buf + sizeof(buf)/sizeof(WCHAR)-1;
         *buf_end-- = 0;
@@ -1074,7 +1251,13 @@ static HRESULT Array_get_value(script_ctx_t *ctx, jsdisp_t *jsthis, jsval_t *r)
 
 static void Array_destructor(jsdisp_t *dispex)
 {
-    heap_free(dispex);
+    ArrayInstance *array = array_from_jsdisp(dispex);
+    DWORD i;
+
+    for(i=0; i < array->elems_cnt; i++)
+        jsval_release(array->elems[i]);
+    heap_free(array->elems);
+    heap_free(array);
 }
 
 static void Array_on_put(jsdisp_t *dispex, const WCHAR *name)
@@ -1083,7 +1266,8 @@ static void Array_on_put(jsdisp_t *dispex, const WCHAR *name)
     const WCHAR *ptr = name;
     DWORD id = 0;
 
-    if(!isdigitW(*ptr))
+    /* names with leading zeros are not array indices */
+    if(!isdigitW(*ptr) || (*ptr == '0' && ptr[1]))
         return;
 
     while(*ptr && isdigitW(*ptr)) {
@@ -1094,10 +1278,97 @@ static void Array_on_put(jsdisp_t *dispex, const WCHAR *name)
     if(*ptr)
         return;
 
+    /* an element was stored in the property map, so dense storage is no longer complete */
+    if(!array->sparse)
+        array_make_sparse(array);
+
     if(id >= array->length)
         array->length = id+1;
 }
 
+static unsigned Array_idx_length(jsdisp_t *jsdisp)
+{
+    return array_from_jsdisp(jsdisp)->elems_cnt;
+}
+
+static HRESULT Array_idx_get(jsdisp_t *jsdisp, unsigned idx, jsval_t *r)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+
+    TRACE("%p[%u]\n", array, idx);
+
+    /* the element may be already gone if the caller holds an old DISPID */
+    if(idx >= array->elems_cnt) {
+        *r = jsval_undefined();
+        return S_OK;
+    }
+
+    return jsval_copy(array->elems[idx], r);
+}
+
+static HRESULT Array_idx_put(jsdisp_t *jsdisp, unsigned idx, jsval_t val)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+    jsval_t copy;
+    HRESULT hres;
+
+    TRACE("%p[%u] = %s\n", array, idx, debugstr_jsval(val));
+
+    if(idx >= array->elems_cnt)
+        return jsdisp_propput_idx(jsdisp, idx, val);
+
+    hres = jsval_copy(val, &copy);
+    if(FAILED(hres))
+        return hres;
+
+    jsval_release(array->elems[idx]);
+    array->elems[idx] = copy;
+    return S_OK;
+}
+
+static HRESULT Array_idx_add(jsdisp_t *jsdisp, unsigned idx)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+    HRESULT hres;
+
+    if(array->sparse)
+        return S_FALSE;
+
+    /* anything but appending would leave a hole */
+    if(idx != array->elems_cnt) {
+        hres = array_make_sparse(array);
+        return FAILED(hres) ? hres : S_FALSE;
+    }
+
+    hres = array_reserve(array, idx+1);
+    if(FAILED(hres))
+        return hres;
+
+    array->elems[array->elems_cnt++] = jsval_undefined();
+    if(array->elems_cnt > array->length)
+        array->length = array->elems_cnt;
+    return S_OK;
+}
+
+static HRESULT Array_idx_delete(jsdisp_t *jsdisp, unsigned idx)
+{
+    ArrayInstance *array = array_from_jsdisp(jsdisp);
+    HRESULT hres;
+
+    TRACE("%p[%u]\n", array, idx);
+
+    if(idx+1 == array->elems_cnt) {
+        jsval_release(array->elems[--array->elems_cnt]);
+        return S_OK;
+    }
+
+    hres = array_make_sparse(array);
+    if(FAILED(hres))
+        return hres;
+
+    return jsdisp_delete_idx(jsdisp, idx);
+}
+
 static const builtin_prop_t Array_props[] = {
     {concatW,                Array_concat,               PROPF_METHOD|1},
     {indexOfW,               Array_indexOf,              PROPF_ES5|PROPF_METHOD|1},
@@ -1121,7 +1392,12 @@ static const builtin_info_t Array_info = {
     sizeof(Array_props)/sizeof(*Array_props),
     Array_props,
     Array_destructor,
-    Array_on_put
+    Array_on_put,
+    Array_idx_length,
+    Array_idx_get,
+    Array_idx_put,
+    Array_idx_add,
+    Array_idx_delete
 };
 
 static const builtin_prop_t ArrayInst_props[] = {
@@ -1134,7 +1410,12 @@ static const builtin_info_t ArrayInst_info = {
     sizeof(ArrayInst_props)/sizeof(*ArrayInst_props),
     ArrayInst_props,
     Array_destructor,
-    Array_on_put
+    Array_on_put,
+    Array_idx_length,
+    Array_idx_get,
+    Array_idx_put,
+    Array_idx_add,
+    Array_idx_delete
 };
 
 /* ECMA-262 5.1 Edition    15.4.3.2 */
@@ -58,9 +58,60 @@ static inline DISPID prop_to_id(jsdisp_t *This, dispex_prop_t *prop)
     return prop - This->props;
 }
 
+static BOOL is_idx_name(const WCHAR *name, unsigned *ret)
+{
+    const WCHAR *ptr;
+    unsigned idx = 0;
+
+    if(!isdigitW(*name) || (*name == '0' && name[1]))
+        return FALSE;
+
+    for(ptr = name; isdigitW(*ptr) && idx < 0x10000000; ptr++)
+        idx = idx*10 + (*ptr-'0');
+    if(*ptr)
+        return FALSE;
+
+    *ret = idx;
+    return TRUE;
+}
+
+static inline DWORD get_idx_flags(jsdisp_t *This)
+{
+    if(!This->builtin_info->idx_put)
+        return PROPF_CONST;
+    return This->builtin_info->idx_add ? PROPF_ENUM : 0;
+}
+
+/*
+ * PROP_IDX props are only handles to the object's indexed storage, which may
+ * grow or shrink behind them, so sync their type with it before use.
+ */
+static void update_idx_prop(jsdisp_t *This, dispex_prop_t *prop)
+{
+    unsigned idx;
+
+    if(prop->type == PROP_IDX) {
+        if(prop->u.idx >= This->builtin_info->idx_length(This))
+            prop->type = PROP_DELETED;
+    }else if(prop->type != PROP_BUILTIN && prop->name
+            && is_idx_name(prop->name, &idx) && idx < This->builtin_info->idx_length(This)) {
+        /* the storage grew over it, this may be an element that was ensured, but never assigned */
+        if(prop->type == PROP_JSVAL)
+            jsval_release(prop->u.val);
+        prop->type = PROP_IDX;
+        prop->flags = get_idx_flags(This);
+        prop->u.idx = idx;
+    }
+}
+
 static inline dispex_prop_t *get_prop(jsdisp_t *This, DISPID id)
 {
-    if(id < 0 || id >= This->prop_cnt || This->props[id].type == PROP_DELETED)
+    if(id < 0 || id >= This->prop_cnt)
+        return NULL;
+
+    if(This->builtin_info->idx_length)
+        update_idx_prop(This, This->props+id);
+    if(This->props[id].type == PROP_DELETED)
         return NULL;
 
     return This->props+id;
@@ -207,6 +258,8 @@ static HRESULT find_prop_name(jsdisp_t *This, unsigned hash, const WCHAR *name,
             }
 
             *ret = &This->props[pos];
+            if(This->builtin_info->idx_length)
+                update_idx_prop(This, *ret);
             return S_OK;
         }
 
@@ -226,13 +279,10 @@ static HRESULT find_prop_name(jsdisp_t *This, unsigned hash, const WCHAR *name,
     }
 
     if(This->builtin_info->idx_length) {
-        const WCHAR *ptr;
-        unsigned idx = 0;
+        unsigned idx;
 
-        for(ptr = name; isdigitW(*ptr) && idx < 0x10000; ptr++)
-            idx = idx*10 + (*ptr-'0');
-        if(!*ptr && idx < This->builtin_info->idx_length(This)) {
-            prop = alloc_prop(This, name, PROP_IDX, This->builtin_info->idx_put ? 0 : PROPF_CONST);
+        if(is_idx_name(name, &idx) && idx < This->builtin_info->idx_length(This)) {
+            prop = alloc_prop(This, name, PROP_IDX, get_idx_flags(This));
             if(!prop)
                 return E_OUTOFMEMORY;
 
@@ -408,9 +458,25 @@ static HRESULT invoke_prop_func(jsdisp_t *This, IDispatch *jsthis, dispex_prop_t
 
         return disp_call_value(This->ctx, get_object(prop->u.val), jsthis, flags, argc, argv, r);
     }
-    case PROP_IDX:
-        FIXME("Invoking PROP_IDX not yet supported\n");
-        return E_NOTIMPL;
+    case PROP_IDX: {
+        jsval_t val;
+
+        hres = This->builtin_info->idx_get(This, prop->u.idx, &val);
+        if(FAILED(hres))
+            return hres;
+
+        if(!is_object_instance(val)) {
+            FIXME("invoke %s\n", debugstr_jsval(val));
+            jsval_release(val);
+            return E_FAIL;
+        }
+
+        TRACE("call %s %p\n", debugstr_w(prop->name), get_object(val));
+
+        hres = disp_call_value(This->ctx, get_object(val), jsthis, flags, argc, argv, r);
+        jsval_release(val);
+        return hres;
+    }
     case PROP_DELETED:
         assert(0);
     }
@@ -516,6 +582,16 @@ HRESULT builtin_set_const(script_ctx_t *ctx, jsdisp_t *jsthis, jsval_t value)
     return S_OK;
 }
 
+/* returns the handle of an element of the indexed storage, creating it if needed */
+static HRESULT find_idx_prop(jsdisp_t *This, unsigned idx, dispex_prop_t **ret)
+{
+    static const WCHAR formatW[] = {'%','u',0};
+    WCHAR name[12];
+
+    sprintfW(name, formatW, idx);
+    return find_prop_name(This, string_hash(name), name, ret);
+}
+
 static HRESULT fill_protrefs(jsdisp_t *This)
 {
     dispex_prop_t *iter, *prop;
@@ -742,7 +818,7 @@ static HRESULT WINAPI DispatchEx_InvokeEx(IDispatchEx *iface, DISPID id, LCID lc
     return hres;
 }
 
-static HRESULT delete_prop(dispex_prop_t *prop, BOOL *ret)
+static HRESULT delete_prop(jsdisp_t *This, dispex_prop_t *prop, BOOL *ret)
 {
     if(prop->flags & PROPF_DONTDELETE) {
         *ret = FALSE;
@@ -751,6 +827,9 @@ static HRESULT delete_prop(dispex_prop_t *prop, BOOL *ret)
 
     *ret = TRUE; /* FIXME: not exactly right */
 
+    if(prop->type == PROP_IDX && This->builtin_info->idx_delete)
+        return This->builtin_info->idx_delete(This, prop->u.idx);
+
     if(prop->type == PROP_JSVAL) {
         jsval_release(prop->u.val);
         prop->type = PROP_DELETED;
@@ -778,7 +857,7 @@ static HRESULT WINAPI DispatchEx_DeleteMemberByName(IDispatchEx *iface, BSTR bst
         return S_OK;
     }
 
-    return delete_prop(prop, &b);
+    return delete_prop(This, prop, &b);
 }
 
 static HRESULT WINAPI DispatchEx_DeleteMemberByDispID(IDispatchEx *iface, DISPID id)
@@ -795,7 +874,7 @@ static HRESULT WINAPI DispatchEx_DeleteMemberByDispID(IDispatchEx *iface, DISPID
         return DISP_E_MEMBERNOTFOUND;
     }
 
-    return delete_prop(prop, &b);
+    return delete_prop(This, prop, &b);
 }
 
 static HRESULT WINAPI DispatchEx_GetMemberProperties(IDispatchEx *iface, DISPID id, DWORD grfdexFetch, DWORD *pgrfdex)
@@ -827,6 +906,7 @@ static HRESULT WINAPI DispatchEx_GetNextDispID(IDispatchEx *iface, DWORD grfdex,
 {
     jsdisp_t *This = impl_from_IDispatchEx(iface);
     dispex_prop_t *iter;
+    BOOL enum_idx;
     HRESULT hres;
 
     TRACE("(%p)->(%x %x %p)\n", This, grfdex, id, pid);
@@ -837,6 +917,32 @@ static HRESULT WINAPI DispatchEx_GetNextDispID(IDispatchEx *iface, DWORD grfdex,
             return hres;
     }
 
+    /* elements of the indexed storage are enumerated first, in index order */
+    enum_idx = This->builtin_info->idx_length && (get_idx_flags(This) & PROPF_ENUM);
+    if(enum_idx) {
+        unsigned idx;
+
+        if(id == DISPID_STARTENUM)
+            idx = 0;
+        else if((iter = get_prop(This, id)) && iter->type == PROP_IDX)
+            idx = iter->u.idx+1;
+        else
+            idx = ~0u;
+
+        if(idx != ~0u) {
+            if(idx < This->builtin_info->idx_length(This)) {
+                hres = find_idx_prop(This, idx, &iter);
+                if(FAILED(hres))
+                    return hres;
+                if(iter) {
+                    *pid = prop_to_id(This, iter);
+                    return S_OK;
+                }
+            }
+            id = DISPID_STARTENUM;
+        }
+    }
+
     if(id+1>=0 && id+1<This->prop_cnt) {
         iter = &This->props[id+1];
     }else {
@@ -845,7 +951,8 @@ static HRESULT WINAPI DispatchEx_GetNextDispID(IDispatchEx *iface, DWORD grfdex,
     }
 
     while(iter < This->props + This->prop_cnt) {
-        if(iter->name && (get_flags(This, iter) & PROPF_ENUM) && iter->type!=PROP_DELETED) {
+        if(iter->name && get_prop(This, prop_to_id(This, iter)) && (get_flags(This, iter) & PROPF_ENUM)
+           && !(enum_idx && iter->type == PROP_IDX)) {
             *pid = prop_to_id(This, iter);
             return S_OK;
         }
@@ -1050,6 +1157,27 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * Same as jsdisp_get_id, but first tries the DISPID that the previous lookup done by the caller
+ * returned. Objects that had their properties added in the same order share DISPIDs, so the
+ * cache hits for them too, and the name comparison makes any stale value harmless.
+ */
+HRESULT jsdisp_get_id_cached(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *cache, DISPID *id)
+{
+    dispex_prop_t *prop;
+    HRESULT hres;
+
+    if(*cache > 0 && (prop = get_prop(jsdisp, *cache)) && prop->name && !strcmpW(prop->name, name)) {
+        *id = *cache;
+        return S_OK;
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(SUCCEEDED(hres))
+        *cache = *id;
+    return hres;
+}
+
 HRESULT jsdisp_call_value(jsdisp_t *jsfunc, IDispatch *jsthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
     HRESULT hres;
@@ -1330,9 +1458,20 @@ HRESULT jsdisp_propput_dontenum(jsdisp_t *obj, const WCHAR *name, jsval_t val)
 HRESULT jsdisp_propput_idx(jsdisp_t *obj, DWORD idx, jsval_t val)
 {
     WCHAR buf[12];
+    HRESULT hres;
 
     static const WCHAR formatW[] = {'%','d',0};
 
+    if(obj->builtin_info->idx_put) {
+        if(idx >= obj->builtin_info->idx_length(obj) && obj->builtin_info->idx_add) {
+            hres = obj->builtin_info->idx_add(obj, idx);
+            if(FAILED(hres))
+                return hres;
+        }
+        if(idx < obj->builtin_info->idx_length(obj))
+            return obj->builtin_info->idx_put(obj, idx, val);
+    }
+
     sprintfW(buf, formatW, idx);
     return jsdisp_propput_name(obj, buf, val);
 }
@@ -1411,6 +1550,9 @@ HRESULT jsdisp_get_idx(jsdisp_t *obj, DWORD idx, jsval_t *r)
 
     static const WCHAR formatW[] = {'%','d',0};
 
+    if(obj->builtin_info->idx_length && idx < obj->builtin_info->idx_length(obj))
+        return obj->builtin_info->idx_get(obj, idx, r);
+
     sprintfW(name, formatW, idx);
 
     hres = find_prop_name_prot(obj, string_hash(name), name, &prop);
@@ -1480,13 +1622,16 @@ HRESULT jsdisp_delete_idx(jsdisp_t *obj, DWORD idx)
     BOOL b;
     HRESULT hres;
 
+    if(obj->builtin_info->idx_delete && idx < obj->builtin_info->idx_length(obj))
+        return obj->builtin_info->idx_delete(obj, idx);
+
     sprintfW(buf, formatW, idx);
 
     hres = find_prop_name(obj, string_hash(buf), buf, &prop);
     if(FAILED(hres) || !prop)
         return hres;
 
-    return delete_prop(prop, &b);
+    return delete_prop(obj, prop, &b);
 }
 
 HRESULT disp_delete(IDispatch *disp, DISPID id, BOOL *ret)
@@ -1501,7 +1646,7 @@ HRESULT disp_delete(IDispatch *disp, DISPID id, BOOL *ret)
 
         prop = get_prop(jsdisp, id);
         if(prop)
-            hres = delete_prop(prop, ret);
+            hres = delete_prop(jsdisp, prop, ret);
         else
             hres = DISP_E_MEMBERNOTFOUND;
 
@@ -1544,7 +1689,7 @@ HRESULT disp_delete_name(script_ctx_t *ctx, IDispatch *disp, jsstr_t *name, BOOL
 
         hres = find_prop_name(jsdisp, string_hash(ptr), ptr, &prop);
         if(prop) {
-            hres = delete_prop(prop, ret);
+            hres = delete_prop(jsdisp, prop, ret);
         }else {
             *ret = TRUE;
             hres = S_OK;
@@ -1592,7 +1737,7 @@ HRESULT jsdisp_is_own_prop(jsdisp_t *obj, const WCHAR *name, BOOL *ret)
     if(FAILED(hres))
         return hres;
 
-    *ret = prop && (prop->type == PROP_JSVAL || prop->type == PROP_BUILTIN);
+    *ret = prop && (prop->type == PROP_JSVAL || prop->type == PROP_BUILTIN || prop->type == PROP_IDX);
     return S_OK;
 }
 
@@ -50,6 +50,7 @@ typedef struct {
     enum {
         EXPRVAL_JSVAL,
         EXPRVAL_IDREF,
+        EXPRVAL_IDX_REF,
         EXPRVAL_STACK_REF,
         EXPRVAL_INVALID
     } type;
@@ -59,11 +60,21 @@ typedef struct {
             IDispatch *disp;
             DISPID id;
         } idref;
+        struct {
+            jsdisp_t *obj;
+            unsigned idx;
+        } idxref;
         unsigned off;
         HRESULT hres;
     } u;
 } exprval_t;
 
+/*
+ * Element references are pushed on the stack like IDREFs, with the index biased
+ * to a value that no DISPID can have in place of the DISPID.
+ */
+#define IDX_REF_BIAS 4294967296.0
+
 static HRESULT stack_push(script_ctx_t *ctx, jsval_t v)
 {
     if(!ctx->stack_size) {
@@ -202,6 +213,13 @@ static HRESULT stack_push_exprval(script_ctx_t *ctx, exprval_t *val)
         else
             IDispatch_Release(val->u.idref.disp);
         return hres;
+    case EXPRVAL_IDX_REF:
+        hres = stack_push(ctx, jsval_obj(val->u.idxref.obj));
+        if(SUCCEEDED(hres))
+            hres = stack_push(ctx, jsval_number(IDX_REF_BIAS + val->u.idxref.idx));
+        else
+            jsdisp_release(val->u.idxref.obj);
+        return hres;
     case EXPRVAL_STACK_REF:
         hres = stack_push(ctx, jsval_number(val->u.off));
         if(SUCCEEDED(hres))
@@ -258,9 +276,15 @@ static BOOL stack_topn_exprval(script_ctx_t *ctx, unsigned n, exprval_t *r)
         return TRUE;
     }
     case JSV_OBJECT:
+        assert(is_number(stack_topn(ctx, n)));
+        if(get_number(stack_topn(ctx, n)) >= IDX_REF_BIAS) {
+            r->type = EXPRVAL_IDX_REF;
+            r->u.idxref.obj = as_jsdisp(get_object(v));
+            r->u.idxref.idx = get_number(stack_topn(ctx, n)) - IDX_REF_BIAS;
+            return TRUE;
+        }
         r->type = EXPRVAL_IDREF;
         r->u.idref.disp = get_object(v);
-        assert(is_number(stack_topn(ctx, n)));
         r->u.idref.id = get_number(stack_topn(ctx, n));
         return TRUE;
     case JSV_UNDEFINED:
@@ -291,6 +315,8 @@ static HRESULT exprval_propput(script_ctx_t *ctx, exprval_t *ref, jsval_t v)
     }
     case EXPRVAL_IDREF:
         return disp_propput(ctx, ref->u.idref.disp, ref->u.idref.id, v);
+    case EXPRVAL_IDX_REF:
+        return jsdisp_propput_idx(ref->u.idxref.obj, ref->u.idxref.idx, v);
     default:
         assert(0);
         return E_FAIL;
@@ -304,6 +330,10 @@ static HRESULT exprval_propget(script_ctx_t *ctx, exprval_t *ref, jsval_t *r)
         return jsval_copy(ctx->stack[ref->u.off], r);
     case EXPRVAL_IDREF:
         return disp_propget(ctx, ref->u.idref.disp, ref->u.idref.id, r);
+    case EXPRVAL_IDX_REF: {
+        HRESULT hres = jsdisp_get_idx(ref->u.idxref.obj, ref->u.idxref.idx, r);
+        return hres == DISP_E_UNKNOWNNAME ? S_OK : hres;
+    }
     default:
         assert(0);
         return E_FAIL;
@@ -325,6 +355,24 @@ static HRESULT exprval_call(script_ctx_t *ctx, exprval_t *ref, WORD flags, unsig
     }
     case EXPRVAL_IDREF:
         return disp_call(ctx, ref->u.idref.disp, ref->u.idref.id, flags, argc, argv, r);
+    case EXPRVAL_IDX_REF: {
+        jsval_t v;
+        HRESULT hres;
+
+        hres = jsdisp_get_idx(ref->u.idxref.obj, ref->u.idxref.idx, &v);
+        if(FAILED(hres) && hres != DISP_E_UNKNOWNNAME)
+            return hres;
+
+        if(!is_object_instance(v)) {
+            FIXME("invoke %s\n", debugstr_jsval(v));
+            jsval_release(v);
+            return E_FAIL;
+        }
+
+        hres = disp_call_value(ctx, get_object(v), to_disp(ref->u.idxref.obj), flags, argc, argv, r);
+        jsval_release(v);
+        return hres;
+    }
     default:
         assert(0);
         return E_FAIL;
@@ -346,6 +394,8 @@ static HRESULT exprval_to_value(script_ctx_t *ctx, exprval_t *ref, jsval_t *r)
 
     if(ref->type == EXPRVAL_IDREF)
         IDispatch_Release(ref->u.idref.disp);
+    else if(ref->type == EXPRVAL_IDX_REF)
+        jsdisp_release(ref->u.idxref.obj);
     return hres;
 }
 
@@ -359,6 +409,9 @@ static void exprval_release(exprval_t *val)
         if(val->u.idref.disp)
             IDispatch_Release(val->u.idref.disp);
         return;
+    case EXPRVAL_IDX_REF:
+        jsdisp_release(val->u.idxref.obj);
+        return;
     case EXPRVAL_STACK_REF:
     case EXPRVAL_INVALID:
         return;
@@ -438,7 +491,8 @@ void scope_release(scope_chain_t *scope)
     heap_free(scope);
 }
 
-static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name, BSTR name_bstr, DWORD flags, DISPID *id)
+static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name, BSTR name_bstr, DWORD flags,
+        DISPID *cache, DISPID *id)
 {
     IDispatchEx *dispex;
     jsdisp_t *jsdisp;
@@ -447,7 +501,10 @@ static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name
 
     jsdisp = iface_to_jsdisp(disp);
     if(jsdisp) {
-        hres = jsdisp_get_id(jsdisp, name, flags, id);
+        if(cache)
+            hres = jsdisp_get_id_cached(jsdisp, name, flags, cache, id);
+        else
+            hres = jsdisp_get_id(jsdisp, name, flags, id);
         jsdisp_release(jsdisp);
         return hres;
     }
@@ -601,7 +658,7 @@ static BOOL lookup_global_members(script_ctx_t *ctx, BSTR identifier, exprval_t
 
     for(item = ctx->named_items; item; item = item->next) {
         if(item->flags & SCRIPTITEM_GLOBALMEMBERS) {
-            hres = disp_get_id(ctx, item->disp, identifier, identifier, 0, &id);
+            hres = disp_get_id(ctx, item->disp, identifier, identifier, 0, NULL, &id);
             if(SUCCEEDED(hres)) {
                 if(ret)
                     exprval_set_disp_ref(ret, item->disp, id);
@@ -624,7 +681,7 @@ local_ref_t *lookup_local(const function_code_t *function, const WCHAR *identifi
 }
 
 /* ECMA-262 3rd Edition    10.1.4 */
-static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *ret)
+static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, DISPID *cache, exprval_t *ret)
 {
     scope_chain_t *scope;
     named_item_t *item;
@@ -653,10 +710,12 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
                         return hres;
                 }
             }
-            if(scope->jsobj)
+            if(scope->jsobj && cache)
+                hres = jsdisp_get_id_cached(scope->jsobj, identifier, fdexNameImplicit, cache, &id);
+            else if(scope->jsobj)
                 hres = jsdisp_get_id(scope->jsobj, identifier, fdexNameImplicit, &id);
             else
-                hres = disp_get_id(ctx, scope->obj, identifier, identifier, fdexNameImplicit, &id);
+                hres = disp_get_id(ctx, scope->obj, identifier, identifier, fdexNameImplicit, cache, &id);
             if(SUCCEEDED(hres)) {
                 exprval_set_disp_ref(ret, scope->obj, id);
                 return S_OK;
@@ -664,7 +723,10 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
         }
     }
 
-    hres = jsdisp_get_id(ctx->global, identifier, 0, &id);
+    if(cache)
+        hres = jsdisp_get_id_cached(ctx->global, identifier, 0, cache, &id);
+    else
+        hres = jsdisp_get_id(ctx->global, identifier, 0, &id);
     if(SUCCEEDED(hres)) {
         exprval_set_disp_ref(ret, to_disp(ctx->global), id);
         return S_OK;
@@ -737,6 +799,13 @@ static inline double get_op_double(script_ctx_t *ctx)
     return frame->bytecode->instrs[frame->ip].u.dbl;
 }
 
+/* property lookup cache of instructions that don't use their second argument */
+static inline DISPID *get_op_cache(script_ctx_t *ctx)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return &frame->bytecode->instrs[frame->ip].u.arg[1].lng;
+}
+
 static inline void jmp_next(script_ctx_t *ctx)
 {
     ctx->call_ctx->ip++;
@@ -1019,6 +1088,7 @@ static HRESULT interp_array(script_ctx_t *ctx)
     jsstr_t *name_str;
     const WCHAR *name;
     jsval_t v, namev;
+    jsdisp_t *jsdisp;
     IDispatch *obj;
     DISPID id;
     HRESULT hres;
@@ -1033,6 +1103,20 @@ static HRESULT interp_array(script_ctx_t *ctx)
         return hres;
     }
 
+    /* array elements don't need to be looked up by their string name */
+    if(is_number(namev) && is_int32(get_number(namev)) && get_number(namev) >= 0
+       && (jsdisp = iface_to_jsdisp(obj))) {
+        hres = jsdisp_get_idx(jsdisp, get_number(namev), &v);
+        jsdisp_release(jsdisp);
+        IDispatch_Release(obj);
+        if(hres == DISP_E_UNKNOWNNAME)
+            hres = S_OK;
+        if(FAILED(hres))
+            return hres;
+
+        return stack_push(ctx, v);
+    }
+
     hres = to_flat_string(ctx, namev, &name_str, &name);
     jsval_release(namev);
     if(FAILED(hres)) {
@@ -1040,7 +1124,7 @@ static HRESULT interp_array(script_ctx_t *ctx)
         return hres;
     }
 
-    hres = disp_get_id(ctx, obj, name, NULL, 0, &id);
+    hres = disp_get_id(ctx, obj, name, NULL, 0, get_op_cache(ctx), &id);
     jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
@@ -1070,7 +1154,7 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    hres = disp_get_id(ctx, obj, arg, arg, 0, get_op_cache(ctx), &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1101,6 +1185,14 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     namev = stack_pop(ctx);
     objv = stack_pop(ctx);
 
+    /* elements are created only when they are assigned, and need no name lookup */
+    if((arg & fdexNameEnsure) && is_object_instance(objv) && get_object(objv) && is_number(namev)
+       && is_int32(get_number(namev)) && get_number(namev) >= 0 && (ref.u.idxref.obj = to_jsdisp(get_object(objv)))) {
+        ref.type = EXPRVAL_IDX_REF;
+        ref.u.idxref.idx = get_number(namev);
+        return stack_push_exprval(ctx, &ref);
+    }
+
     hres = to_object(ctx, objv, &obj);
     jsval_release(objv);
     if(SUCCEEDED(hres)) {
@@ -1112,7 +1204,7 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
+    hres = disp_get_id(ctx, obj, name, NULL, arg, get_op_cache(ctx), &id);
     jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         ref.type = EXPRVAL_IDREF;
@@ -1229,7 +1321,7 @@ static HRESULT interp_identifier_ref(script_ctx_t *ctx, BSTR identifier, unsigne
     exprval_t exprval;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, identifier, &exprval);
+    hres = identifier_eval(ctx, identifier, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1252,13 +1344,13 @@ static HRESULT interp_identifier_ref(script_ctx_t *ctx, BSTR identifier, unsigne
     return stack_push_exprval(ctx, &exprval);
 }
 
-static HRESULT identifier_value(script_ctx_t *ctx, BSTR identifier)
+static HRESULT identifier_value(script_ctx_t *ctx, BSTR identifier, DISPID *cache)
 {
     exprval_t exprval;
     jsval_t v;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, identifier, &exprval);
+    hres = identifier_eval(ctx, identifier, cache, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1299,7 +1391,7 @@ static HRESULT interp_local(script_ctx_t *ctx)
     TRACE("%d: %s\n", arg, debugstr_w(local_name(frame, arg)));
 
     if(!frame->base_scope || !frame->base_scope->frame)
-        return identifier_value(ctx, local_name(frame, arg));
+        return identifier_value(ctx, local_name(frame, arg), NULL);
 
     hres = jsval_copy(ctx->stack[local_off(frame, arg)], &copy);
     if(FAILED(hres))
@@ -1315,7 +1407,7 @@ static HRESULT interp_ident(script_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    return identifier_value(ctx, arg);
+    return identifier_value(ctx, arg, get_op_cache(ctx));
 }
 
 /* ECMA-262 3rd Edition    10.1.4 */
@@ -1648,7 +1740,7 @@ static HRESULT interp_in(script_ctx_t *ctx)
         return hres;
     }
 
-    hres = disp_get_id(ctx, get_object(obj), str, NULL, 0, &id);
+    hres = disp_get_id(ctx, get_object(obj), str, NULL, 0, NULL, &id);
     IDispatch_Release(get_object(obj));
     jsstr_release(jsstr);
     if(SUCCEEDED(hres))
@@ -1856,7 +1948,7 @@ static HRESULT interp_delete_ident(script_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx, arg, &exprval);
+    hres = identifier_eval(ctx, arg, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1967,7 +2059,7 @@ static HRESULT interp_typeofident(script_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx, arg, &exprval);
+    hres = identifier_eval(ctx, arg, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -2820,7 +2912,7 @@ static HRESULT bind_event_target(script_ctx_t *ctx, function_code_t *func, jsdis
     jsval_t v;
     HRESULT hres;
 
-    hres = identifier_eval(ctx, func->event_target, &exprval);
+    hres = identifier_eval(ctx, func->event_target, NULL, &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1131,6 +1131,68 @@ arr[12] = 2;
 ok(arr.slice(5).toString() === "a,,,,,,,2", "arr.slice(5).toString() = " + arr.slice(5).toString());
 ok(arr.slice(5).length === 8, "arr.slice(5).length = " + arr.slice(5).length);
 
+arr = [];
+for(i=0; i < 100; i++)
+    arr.push(i);
+arr[arr.length] = 100;
+ok(arr.length === 101, "arr.length = " + arr.length);
+ok(arr.slice(98).toString() === "98,99,100", "arr.slice(98) = " + arr.slice(98));
+ok(arr.hasOwnProperty("100"), "arr[100] is not own property");
+ok(!arr.hasOwnProperty("0100"), "arr[\"0100\"] is own property");
+ok(arr["0100"] === undefined, "arr[\"0100\"] = " + arr["0100"]);
+delete arr[100];
+ok(arr.length === 101, "arr.length = " + arr.length);
+ok(!("100" in arr), "arr[100] not deleted");
+delete arr[50];
+ok(arr[50] === undefined, "arr[50] = " + arr[50]);
+ok(!(50 in arr), "arr[50] not deleted");
+ok(arr[51] === 51, "arr[51] = " + arr[51]);
+arr[50] = "x";
+ok(arr.slice(49, 52).toString() === "49,x,51", "arr.slice(49, 52) = " + arr.slice(49, 52));
+arr.length = 2;
+ok(arr.toString() === "0,1", "arr = " + arr);
+ok(arr[50] === undefined, "arr[50] = " + arr[50]);
+
+arr = [1,2,3];
+ok(arr["2"] === 3, "arr[\"2\"] = " + arr["2"]);
+arr.pop();
+tmp = 0;
+for(i in arr)
+    tmp += arr[i];
+ok(tmp === 3, "sum = " + tmp);
+ok(arr["2"] === undefined, "arr[\"2\"] = " + arr["2"]);
+arr[2] = 4;
+ok(arr.toString() === "1,2,4", "arr = " + arr);
+arr["01"] = 5;
+ok(arr.length === 3, "arr.length = " + arr.length);
+ok(arr[1] === 2, "arr[1] = " + arr[1]);
+arr.unshift(-1, 0);
+tmp = "";
+for(i in arr)
+    tmp += i + ":" + arr[i] + ",";
+ok(tmp === "0:-1,1:0,2:1,3:2,4:4,01:5,", "for in = " + tmp);
+
+arr = [1,2,3];
+arr[arr.length] = arr.length;
+ok(arr.toString() === "1,2,3,3", "arr = " + arr);
+arr[arr.length] = (2 in arr) + "," + (4 in arr);
+ok(arr[4] === "true,false", "arr[4] = " + arr[4]);
+try {
+    arr[arr.length] = (function() { throw 1; })();
+}catch(e) {}
+ok(arr.length === 5, "arr.length = " + arr.length);
+ok(!(5 in arr), "arr[5] exists");
+arr[arr.length-1] += "!";
+ok(arr[4] === "true,false!", "arr[4] = " + arr[4]);
+for(i = 0; i < 3; i++)
+    arr[7] = i;
+ok(arr.length === 8, "arr.length = " + arr.length);
+ok(arr[7] === 2, "arr[7] = " + arr[7]);
+ok(!(6 in arr), "arr[6] exists");
+
+arr = [function() { return this; }];
+ok(arr[0]() === arr, "arr[0]() !== arr");
+
 arr = [1,2,3,4,5];
 tmp = arr.splice(2,2);
 ok(tmp.toString() == "3,4", "arr.splice(2,2) returned " + tmp.toString());
@@ -1797,6 +1797,34 @@ ok(tmp, "tmp = " + tmp);
     ok(x === undefined, "x = " + x);
 })();
 
+/* property lookups done by the same instruction on different objects */
+(function() {
+    function Proto() {}
+    Proto.prototype.a = "proto";
+
+    var objs = [{a: 1, b: 2}, {b: 3, a: 4}, {c: 5}, new Proto(), {a: 6, b: 7}], i, r = "";
+
+    delete objs[4].a;
+    objs[4].c = 8;
+    for(i = 0; i < objs.length; i++)
+        r += objs[i].a + ",";
+    ok(r === "1,4,undefined,proto,undefined,", "r = " + r);
+
+    objs[3].a = "own";
+    r = "";
+    for(i = 0; i < objs.length; i++)
+        r += objs[i]["a"] + ",";
+    ok(r === "1,4,undefined,own,undefined,", "r = " + r);
+
+    delete objs[3].a;
+    r = "";
+    for(i = 0; i < 2; i++) {
+        r += objs[3].a + ",";
+        objs[3].a = i;
+    }
+    ok(r === "proto,0,", "r = " + r);
+})();
+
 /* NoNewline rule parser tests */
 while(true) {
     if(true) break
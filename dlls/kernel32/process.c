@@ -1954,6 +1954,145 @@ static pid_t exec_loader( LPCWSTR cmd_line, unsigned int flags, int socketfd,
     return pid;
 }
 
+/***********************************************************************
+ *           use_server_spawn
+ *
+ * Check if new processes should be started by the wineserver (WINESERVERSPAWN=1).
+ */
+static BOOL use_server_spawn(void)
+{
+    static int enabled = -1;
+
+    if (enabled == -1)
+    {
+        const char *env = getenv( "WINESERVERSPAWN" );
+        enabled = env && atoi( env );
+    }
+    return enabled;
+}
+
+/* check if a Unix environment entry sets the given variable */
+static BOOL is_env_var( const char *entry, const char *var )
+{
+    size_t len = strchr( var, '=' ) - var + 1;
+    return !strncmp( entry, var, len );
+}
+
+/***********************************************************************
+ *           spawn_loader
+ *
+ * Let the wineserver fork and exec the loader for the new process.
+ * Unlike exec_loader, this doesn't need to fork the current process,
+ * which gets expensive for processes with a large address space.
+ * Only the standard fds and the server socket are passed to the child.
+ */
+static pid_t spawn_loader( LPCWSTR cmd_line, unsigned int flags, int socketfd,
+                           int stdin_fd, int stdout_fd, const char *unixdir, char *winedebug,
+                           const struct binary_info *binary_info )
+{
+    char **unix_env = __wine_get_main_environment();
+    char preloader_reserve[64];
+    char *wineloader = NULL, *vars[3], *data = NULL, *p;
+    char **argv;
+    const char *loader;
+    data_size_t loader_size, argv_size, env_size = 0, size;
+    unsigned int i, j, nb_vars = 0;
+    NTSTATUS status;
+    pid_t pid = -1;
+
+    /* the child is supposed to inherit our current directory in that case */
+    if (!unixdir) return -1;
+
+    if (!is_win64 ^ !(binary_info->flags & BINARY_FLAG_64BIT))
+        loader = get_alternate_loader( &wineloader );
+    else if (wine_get_build_dir())
+        loader = is_win64 ? "loader/wine64" : "loader/wine";
+    else
+        loader = is_win64 ? "wine64" : "wine";
+
+    if (!(argv = build_argv( cmd_line, 1 ))) goto done;
+
+    sprintf( preloader_reserve, "WINEPRELOADRESERVE=%x%08x-%x%08x",
+             (ULONG)(binary_info->res_start >> 32), (ULONG)binary_info->res_start,
+             (ULONG)(binary_info->res_end >> 32), (ULONG)binary_info->res_end );
+    vars[nb_vars++] = preloader_reserve;
+    if (winedebug) vars[nb_vars++] = winedebug;
+    if (wineloader) vars[nb_vars++] = wineloader;
+
+    /* compute the size of the data */
+
+    loader_size = strlen( loader ) + 1;
+    for (i = 1, argv_size = 0; argv[i]; i++) argv_size += strlen( argv[i] ) + 1;
+    for (i = 0; i < nb_vars; i++) env_size += strlen( vars[i] ) + 1;
+    for (i = 0; unix_env[i]; i++)
+    {
+        if (!strncmp( unix_env[i], "WINESERVERSOCKET=", sizeof("WINESERVERSOCKET=") - 1 )) continue;
+        for (j = 0; j < nb_vars; j++) if (is_env_var( unix_env[i], vars[j] )) break;
+        if (j == nb_vars) env_size += strlen( unix_env[i] ) + 1;
+    }
+    size = loader_size + argv_size + env_size + strlen( unixdir ) + 1;
+    if (!(data = HeapAlloc( GetProcessHeap(), 0, size ))) goto done;
+
+    /* and fill it */
+
+    p = data;
+    strcpy( p, loader );
+    p += loader_size;
+    for (i = 1; argv[i]; i++)
+    {
+        strcpy( p, argv[i] );
+        p += strlen( p ) + 1;
+    }
+    for (i = 0; i < nb_vars; i++)
+    {
+        strcpy( p, vars[i] );
+        p += strlen( p ) + 1;
+    }
+    for (i = 0; unix_env[i]; i++)
+    {
+        if (!strncmp( unix_env[i], "WINESERVERSOCKET=", sizeof("WINESERVERSOCKET=") - 1 )) continue;
+        for (j = 0; j < nb_vars; j++) if (is_env_var( unix_env[i], vars[j] )) break;
+        if (j != nb_vars) continue;
+        strcpy( p, unix_env[i] );
+        p += strlen( p ) + 1;
+    }
+    strcpy( p, unixdir );
+
+    if (flags & (CREATE_NEW_PROCESS_GROUP | CREATE_NEW_CONSOLE | DETACHED_PROCESS))
+        stdin_fd = stdout_fd = -1;  /* use /dev/null */
+    else
+    {
+        if (stdin_fd == -1) stdin_fd = 0;
+        if (stdout_fd == -1) stdout_fd = 1;
+    }
+    wine_server_send_fd( socketfd );
+    if (stdin_fd != -1) wine_server_send_fd( stdin_fd );
+    if (stdout_fd != -1) wine_server_send_fd( stdout_fd );
+    wine_server_send_fd( 2 );
+
+    SERVER_START_REQ( spawn_process )
+    {
+        req->socket_fd    = socketfd;
+        req->stdin_fd     = stdin_fd;
+        req->stdout_fd    = stdout_fd;
+        req->stderr_fd    = 2;
+        req->create_flags = flags;
+        req->loader_size  = loader_size;
+        req->argv_size    = argv_size;
+        req->env_size     = env_size;
+        wine_server_add_data( req, data, size );
+        if (!(status = wine_server_call( req ))) pid = reply->pid;
+    }
+    SERVER_END_REQ;
+    if (status) WARN( "failed to spawn process, status %x\n", status );
+
+done:
+    HeapFree( GetProcessHeap(), 0, data );
+    HeapFree( GetProcessHeap(), 0, wineloader );
+    HeapFree( GetProcessHeap(), 0, argv );
+    return pid;
+}
+
 /***********************************************************************
  *           create_process
  *
@@ -2120,8 +2259,13 @@ static BOOL create_process( HANDLE hFile, LPCWSTR filename, LPWSTR cmd_line, LPW
 
     /* create the child process */
 
-    pid = exec_loader( cmd_line, flags, socketfd[0], stdin_fd, stdout_fd, unixdir,
-                       winedebug, binary_info, FALSE );
+    pid = -1;
+    if (use_server_spawn())
+        pid = spawn_loader( cmd_line, flags, socketfd[0], stdin_fd, stdout_fd, unixdir,
+                            winedebug, binary_info );
+    if (pid == -1)
+        pid = exec_loader( cmd_line, flags, socketfd[0], stdin_fd, stdout_fd, unixdir,
+                           winedebug, binary_info, FALSE );
 
     if (stdin_fd != -1) close( stdin_fd );
     if (stdout_fd != -1) close( stdout_fd );
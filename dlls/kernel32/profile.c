@@ -48,15 +48,20 @@ typedef enum
 
 typedef struct tagPROFILEKEY
 {
-    WCHAR                 *value;
-    struct tagPROFILEKEY  *next;
-    WCHAR                  name[1];
+    WCHAR                     *value;
+    struct tagPROFILEKEY      *next;
+    struct tagPROFILEKEY      *hash_next;  /* next key in the same index bucket */
+    struct tagPROFILESECTION  *section;    /* section of the key, set when indexed */
+    DWORD                      hash;
+    WCHAR                      name[1];
 } PROFILEKEY;
 
 typedef struct tagPROFILESECTION
 {
     struct tagPROFILEKEY       *key;
     struct tagPROFILESECTION   *next;
+    struct tagPROFILESECTION   *hash_next;  /* next section in the same index bucket */
+    DWORD                       hash;
     WCHAR                       name[1];
 } PROFILESECTION;
 
@@ -65,16 +70,27 @@ typedef struct
 {
     BOOL             changed;
     PROFILESECTION  *section;
+    PROFILESECTION **section_index;  /* buckets of the named sections, NULL until first needed */
+    PROFILEKEY     **key_index;      /* buckets of their keys, by section and key name */
+    unsigned int     index_size;     /* number of buckets, a power of 2 */
+    unsigned int     index_count;    /* number of indexed keys */
     WCHAR           *filename;
     FILETIME LastWriteTime;
+    DWORD FileSize;
+    DWORD LastCheck;
     ENCODING encoding;
 } PROFILE;
 
 
 #define N_CACHED_PROFILES 10
+#define MAX_CACHED_PROFILES 256
 
 /* Cached profile files */
-static PROFILE *MRUProfile[N_CACHED_PROFILES]={NULL};
+static PROFILE *MRUProfile[MAX_CACHED_PROFILES]={NULL};
+
+/* number of cached profiles, and time in ms during which a cached profile isn't checked for changes */
+static int profile_cache_size = N_CACHED_PROFILES;
+static DWORD profile_refresh_interval;
 
 #define CurProfile (MRUProfile[0])
 
@@ -267,6 +283,118 @@ static void PROFILE_Free( PROFILESECTION *section )
     }
 }
 
+/* case insensitive hash of a section or key name */
+static inline DWORD PROFILE_Hash( LPCWSTR name, int len )
+{
+    DWORD hash = 0;
+
+    while (len--) hash = hash * 31 + tolowerW( *name++ );
+    return hash;
+}
+
+/***********************************************************************
+ *           PROFILE_FreeIndex
+ *
+ * Free the hash index of a profile tree.
+ */
+static void PROFILE_FreeIndex( PROFILE *profile )
+{
+    HeapFree( GetProcessHeap(), 0, profile->section_index );
+    HeapFree( GetProcessHeap(), 0, profile->key_index );
+    profile->section_index = NULL;
+    profile->key_index = NULL;
+    profile->index_size = 0;
+    profile->index_count = 0;
+}
+
+static inline PROFILEKEY **PROFILE_KeyBucket( PROFILE *profile, const PROFILESECTION *section, DWORD hash )
+{
+    return &profile->key_index[(section->hash * 31 + hash) & (profile->index_size - 1)];
+}
+
+/* buckets are filled in file order, so they hold the nodes in reverse order */
+static void PROFILE_IndexKey( PROFILE *profile, PROFILESECTION *section, PROFILEKEY *key )
+{
+    PROFILEKEY **bucket = PROFILE_KeyBucket( profile, section, key->hash );
+
+    key->section = section;
+    key->hash_next = *bucket;
+    *bucket = key;
+    profile->index_count++;
+}
+
+static void PROFILE_UnindexKey( PROFILE *profile, PROFILEKEY *key )
+{
+    PROFILEKEY **bucket;
+
+    if (!profile->key_index) return;
+    for (bucket = PROFILE_KeyBucket( profile, key->section, key->hash ); *bucket; bucket = &(*bucket)->hash_next)
+    {
+        if (*bucket != key) continue;
+        *bucket = key->hash_next;
+        profile->index_count--;
+        break;
+    }
+}
+
+static void PROFILE_IndexSection( PROFILE *profile, PROFILESECTION *section )
+{
+    PROFILESECTION **bucket = &profile->section_index[section->hash & (profile->index_size - 1)];
+
+    section->hash_next = *bucket;
+    *bucket = section;
+}
+
+static void PROFILE_UnindexSection( PROFILE *profile, PROFILESECTION *section )
+{
+    PROFILESECTION **bucket;
+    PROFILEKEY *key;
+
+    if (!profile->section_index || !section->name[0]) return;
+    for (key = section->key; key; key = key->next) PROFILE_UnindexKey( profile, key );
+    for (bucket = &profile->section_index[section->hash & (profile->index_size - 1)]; *bucket;
+         bucket = &(*bucket)->hash_next)
+    {
+        if (*bucket != section) continue;
+        *bucket = section->hash_next;
+        break;
+    }
+}
+
+/***********************************************************************
+ *           PROFILE_BuildIndex
+ *
+ * (Re)build the hash index of a profile tree, sized for its current keys.
+ */
+static BOOL PROFILE_BuildIndex( PROFILE *profile )
+{
+    PROFILESECTION *section;
+    PROFILEKEY *key;
+    unsigned int count = 0, size = 16;
+
+    for (section = profile->section; section; section = section->next)
+        for (key = section->key; key; key = key->next) count++;
+    while (size < count) size *= 2;
+
+    PROFILE_FreeIndex( profile );
+    profile->section_index = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, size * sizeof(PROFILESECTION *) );
+    profile->key_index = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, size * sizeof(PROFILEKEY *) );
+    if (!profile->section_index || !profile->key_index)
+    {
+        PROFILE_FreeIndex( profile );
+        return FALSE;
+    }
+    profile->index_size = size;
+
+    for (section = profile->section; section; section = section->next)
+    {
+        if (!section->name[0]) continue;
+        PROFILE_IndexSection( profile, section );
+        for (key = section->key; key; key = key->next) PROFILE_IndexKey( profile, section, key );
+    }
+    return TRUE;
+}
+
 /* returns TRUE if a whitespace character, else FALSE */
 static inline BOOL PROFILE_isspaceW(WCHAR c)
 {
@@ -392,6 +520,7 @@ static PROFILESECTION *PROFILE_Load(HANDLE hFile, ENCODING * pEncoding)
         return NULL;
     }
     first_section->name[0] = 0;
+    first_section->hash = 0;
     first_section->key  = NULL;
     first_section->next = NULL;
     next_section = &first_section->next;
@@ -434,6 +563,7 @@ static PROFILESECTION *PROFILE_Load(HANDLE hFile, ENCODING * pEncoding)
                     break;
                 memcpy(section->name, szLineStart, len * sizeof(WCHAR));
                 section->name[len] = '\0';
+                section->hash = PROFILE_Hash( section->name, len );
                 section->key  = NULL;
                 section->next = NULL;
                 *next_section = section;
@@ -466,6 +596,7 @@ static PROFILESECTION *PROFILE_Load(HANDLE hFile, ENCODING * pEncoding)
             if (!(key = HeapAlloc( GetProcessHeap(), 0, sizeof(*key) + len * sizeof(WCHAR) ))) break;
             memcpy(key->name, szLineStart, len * sizeof(WCHAR));
             key->name[len] = '\0';
+            key->hash = PROFILE_Hash( key->name, len );
             if (szValueStart)
             {
                 len = (int)(szLineEnd - szValueStart);
@@ -503,6 +634,7 @@ static BOOL PROFILE_DeleteSection( PROFILESECTION **section, LPCWSTR name )
         if ((*section)->name[0] && !strcmpiW( (*section)->name, name ))
         {
             PROFILESECTION *to_del = *section;
+            PROFILE_UnindexSection( CurProfile, to_del );
             *section = to_del->next;
             to_del->next = NULL;
             PROFILE_Free( to_del );
@@ -532,6 +664,7 @@ static BOOL PROFILE_DeleteKey( PROFILESECTION **section,
                 if (!strcmpiW( (*key)->name, key_name ))
                 {
                     PROFILEKEY *to_del = *key;
+                    PROFILE_UnindexKey( CurProfile, to_del );
                     *key = to_del->next;
                     HeapFree( GetProcessHeap(), 0, to_del->value);
                     HeapFree( GetProcessHeap(), 0, to_del );
@@ -562,6 +695,7 @@ static void PROFILE_DeleteAllKeys( LPCWSTR section_name)
             while (*key)
             {
                 PROFILEKEY *to_del = *key;
+                PROFILE_UnindexKey( CurProfile, to_del );
 		*key = to_del->next;
                 HeapFree( GetProcessHeap(), 0, to_del->value);
 		HeapFree( GetProcessHeap(), 0, to_del );
@@ -583,6 +717,9 @@ static PROFILEKEY *PROFILE_Find( PROFILESECTION **section, LPCWSTR section_name,
 {
     LPCWSTR p;
     int seclen, keylen;
+    DWORD sechash, keyhash;
+    PROFILESECTION *iter, *found_section = NULL;
+    PROFILEKEY **key, *k, *found_key = NULL;
 
     while (PROFILE_isspaceW(*section_name)) section_name++;
     if (*section_name)
@@ -602,54 +739,81 @@ static PROFILEKEY *PROFILE_Find( PROFILESECTION **section, LPCWSTR section_name,
     while ((p > key_name) && PROFILE_isspaceW(*p)) p--;
     keylen = p - key_name + 1;
 
-    while (*section)
+    if (!CurProfile->section_index && !PROFILE_BuildIndex( CurProfile )) return NULL;
+
+    sechash = PROFILE_Hash( section_name, seclen );
+    keyhash = PROFILE_Hash( key_name, keylen );
+
+    /* the last match in a bucket is the first one in the file */
+    for (iter = CurProfile->section_index[sechash & (CurProfile->index_size - 1)]; iter; iter = iter->hash_next)
     {
-        if ( ((*section)->name[0])
-             && (!(strncmpiW( (*section)->name, section_name, seclen )))
-             && (((*section)->name)[seclen] == '\0') )
-        {
-            PROFILEKEY **key = &(*section)->key;
+        if ( iter->hash == sechash
+             && (!(strncmpiW( iter->name, section_name, seclen )))
+             && (iter->name[seclen] == '\0') )
+            found_section = iter;
+    }
 
-            while (*key)
+    if (found_section)
+    {
+        /* If create_always is FALSE then we check if the keyname
+         * already exists. Otherwise we add it regardless of its
+         * existence, to allow keys to be added more than once in
+         * some cases.
+         */
+        if(!create_always)
+        {
+            for (k = *PROFILE_KeyBucket( CurProfile, found_section, keyhash ); k; k = k->hash_next)
             {
-                /* If create_always is FALSE then we check if the keyname
-                 * already exists. Otherwise we add it regardless of its
-                 * existence, to allow keys to be added more than once in
-                 * some cases.
-                 */
-                if(!create_always)
-                {
-                    if ( (!(strncmpiW( (*key)->name, key_name, keylen )))
-                         && (((*key)->name)[keylen] == '\0') )
-                        return *key;
-                }
-                key = &(*key)->next;
+                if ( k->section == found_section && k->hash == keyhash
+                     && (!(strncmpiW( k->name, key_name, keylen )))
+                     && ((k->name)[keylen] == '\0') )
+                    found_key = k;
             }
-            if (!create) return NULL;
-            if (!(*key = HeapAlloc( GetProcessHeap(), 0, sizeof(PROFILEKEY) + strlenW(key_name) * sizeof(WCHAR) )))
-                return NULL;
-            strcpyW( (*key)->name, key_name );
-            (*key)->value = NULL;
-            (*key)->next  = NULL;
-            return *key;
+            if (found_key) return found_key;
         }
-        section = &(*section)->next;
+        if (!create) return NULL;
+        for (key = &found_section->key; *key; key = &(*key)->next)
+            ;
+        if (!(*key = HeapAlloc( GetProcessHeap(), 0, sizeof(PROFILEKEY) + strlenW(key_name) * sizeof(WCHAR) )))
+            return NULL;
+        strcpyW( (*key)->name, key_name );
+        (*key)->hash  = PROFILE_Hash( key_name, strlenW(key_name) );
+        (*key)->value = NULL;
+        (*key)->next  = NULL;
+        PROFILE_IndexKey( CurProfile, found_section, *key );
     }
-    if (!create) return NULL;
-    *section = HeapAlloc( GetProcessHeap(), 0, sizeof(PROFILESECTION) + strlenW(section_name) * sizeof(WCHAR) );
-    if(*section == NULL) return NULL;
-    strcpyW( (*section)->name, section_name );
-    (*section)->next = NULL;
-    if (!((*section)->key  = HeapAlloc( GetProcessHeap(), 0,
-                                        sizeof(PROFILEKEY) + strlenW(key_name) * sizeof(WCHAR) )))
+    else
     {
-        HeapFree(GetProcessHeap(), 0, *section);
-        return NULL;
+        if (!create) return NULL;
+        while (*section) section = &(*section)->next;
+        *section = HeapAlloc( GetProcessHeap(), 0, sizeof(PROFILESECTION) + strlenW(section_name) * sizeof(WCHAR) );
+        if(*section == NULL) return NULL;
+        strcpyW( (*section)->name, section_name );
+        (*section)->hash = PROFILE_Hash( section_name, strlenW(section_name) );
+        (*section)->next = NULL;
+        if (!((*section)->key  = HeapAlloc( GetProcessHeap(), 0,
+                                            sizeof(PROFILEKEY) + strlenW(key_name) * sizeof(WCHAR) )))
+        {
+            HeapFree(GetProcessHeap(), 0, *section);
+            *section = NULL;
+            return NULL;
+        }
+        key = &(*section)->key;
+        strcpyW( (*key)->name, key_name );
+        (*key)->hash  = PROFILE_Hash( key_name, strlenW(key_name) );
+        (*key)->value = NULL;
+        (*key)->next  = NULL;
+        if ((*section)->name[0])
+        {
+            PROFILE_IndexSection( CurProfile, *section );
+            PROFILE_IndexKey( CurProfile, *section, *key );
+        }
     }
-    strcpyW( (*section)->key->name, key_name );
-    (*section)->key->value = NULL;
-    (*section)->key->next  = NULL;
-    return (*section)->key;
+
+    k = *key;
+    /* keep the buckets short as keys are added */
+    if (CurProfile->index_count > CurProfile->index_size * 2) PROFILE_BuildIndex( CurProfile );
+    return k;
 }
 
 
@@ -684,6 +848,8 @@ static BOOL PROFILE_FlushFile(void)
     PROFILE_Save( hFile, CurProfile->section, CurProfile->encoding );
     if(GetFileTime(hFile, NULL, NULL, &LastWriteTime))
        CurProfile->LastWriteTime=LastWriteTime;
+    CurProfile->FileSize = GetFileSize(hFile, NULL);
+    CurProfile->LastCheck = GetTickCount();
     CloseHandle( hFile );
     CurProfile->changed = FALSE;
     return TRUE;
@@ -698,6 +864,7 @@ static BOOL PROFILE_FlushFile(void)
 static void PROFILE_ReleaseFile(void)
 {
     PROFILE_FlushFile();
+    PROFILE_FreeIndex( CurProfile );
     PROFILE_Free( CurProfile->section );
     HeapFree( GetProcessHeap(), 0, CurProfile->filename );
     CurProfile->changed = FALSE;
@@ -705,6 +872,8 @@ static void PROFILE_ReleaseFile(void)
     CurProfile->filename  = NULL;
     CurProfile->encoding = ENCODING_ANSI;
     ZeroMemory(&CurProfile->LastWriteTime, sizeof(CurProfile->LastWriteTime));
+    CurProfile->FileSize = 0;
+    CurProfile->LastCheck = 0;
 }
 
 /***********************************************************************
@@ -727,6 +896,92 @@ static BOOL is_not_current(FILETIME * ft)
     return ftll + 21000000 < nowll;
 }
 
+/***********************************************************************
+ *           PROFILE_GetOption
+ *
+ * Read a numeric option from the HKCU\Software\Wine\Profile key.
+ */
+static DWORD PROFILE_GetOption( HANDLE hkey, LPCWSTR name, DWORD def )
+{
+    char buffer[offsetof(KEY_VALUE_PARTIAL_INFORMATION, Data) + 16 * sizeof(WCHAR)];
+    KEY_VALUE_PARTIAL_INFORMATION *info = (KEY_VALUE_PARTIAL_INFORMATION *)buffer;
+    UNICODE_STRING nameW;
+    DWORD size;
+
+    RtlInitUnicodeString( &nameW, name );
+    if (NtQueryValueKey( hkey, &nameW, KeyValuePartialInformation,
+                         buffer, sizeof(buffer) - sizeof(WCHAR), &size ))
+        return def;
+
+    if (info->Type == REG_DWORD) memcpy( &def, info->Data, sizeof(DWORD) );
+    else if (info->Type == REG_SZ)
+    {
+        WCHAR *str = (WCHAR *)info->Data;
+        str[info->DataLength / sizeof(WCHAR)] = 0;
+        def = atoiW( str );
+    }
+    return def;
+}
+
+/***********************************************************************
+ *           PROFILE_LoadOptions
+ *
+ * Read the size of the profile cache and its refresh interval.
+ */
+static void PROFILE_LoadOptions(void)
+{
+    static const WCHAR profileW[] = {'S','o','f','t','w','a','r','e','\\',
+                                     'W','i','n','e','\\','P','r','o','f','i','l','e',0};
+    static const WCHAR cachesizeW[] = {'C','a','c','h','e','S','i','z','e',0};
+    static const WCHAR refreshW[] = {'R','e','f','r','e','s','h','I','n','t','e','r','v','a','l',0};
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING nameW;
+    HANDLE root, hkey;
+
+    if (RtlOpenCurrentUser( KEY_READ, &root )) return;
+    attr.Length = sizeof(attr);
+    attr.RootDirectory = root;
+    attr.ObjectName = &nameW;
+    attr.Attributes = 0;
+    attr.SecurityDescriptor = NULL;
+    attr.SecurityQualityOfService = NULL;
+    RtlInitUnicodeString( &nameW, profileW );
+
+    /* @@ Wine registry key: HKCU\Software\Wine\Profile */
+    if (!NtOpenKey( &hkey, KEY_READ, &attr ))
+    {
+        profile_cache_size = PROFILE_GetOption( hkey, cachesizeW, N_CACHED_PROFILES );
+        profile_cache_size = max( 1, min( profile_cache_size, MAX_CACHED_PROFILES ));
+        profile_refresh_interval = PROFILE_GetOption( hkey, refreshW, 0 );
+        NtClose( hkey );
+    }
+    NtClose( root );
+    TRACE("caching %d profiles, refresh interval %u ms\n", profile_cache_size, profile_refresh_interval);
+}
+
+/***********************************************************************
+ *           PROFILE_IsCurrent
+ *
+ * Check whether the cached copy of a profile is still up to date, without opening the file.
+ */
+static BOOL PROFILE_IsCurrent( PROFILE *profile )
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    DWORD now = GetTickCount();
+
+    if (profile->changed || !profile->LastCheck) return FALSE;
+    if (now - profile->LastCheck < profile_refresh_interval) return TRUE;
+
+    if (!GetFileAttributesExW( profile->filename, GetFileExInfoStandard, &data ) ||
+        memcmp( &profile->LastWriteTime, &data.ftLastWriteTime, sizeof(FILETIME) ) ||
+        data.nFileSizeHigh || profile->FileSize != data.nFileSizeLow ||
+        !is_not_current( &data.ftLastWriteTime ))
+        return FALSE;
+
+    profile->LastCheck = now;
+    return TRUE;
+}
+
 /***********************************************************************
  *           PROFILE_Open
  *
@@ -745,16 +1000,25 @@ static BOOL PROFILE_Open( LPCWSTR filename, BOOL write_access )
     /* First time around */
 
     if(!CurProfile)
-       for(i=0;i<N_CACHED_PROFILES;i++)
+    {
+       PROFILE_LoadOptions();
+       for(i=0;i<profile_cache_size;i++)
        {
           MRUProfile[i]=HeapAlloc( GetProcessHeap(), 0, sizeof(PROFILE) );
           if(MRUProfile[i] == NULL) break;
           MRUProfile[i]->changed=FALSE;
           MRUProfile[i]->section=NULL;
+          MRUProfile[i]->section_index=NULL;
+          MRUProfile[i]->key_index=NULL;
+          MRUProfile[i]->index_size=0;
+          MRUProfile[i]->index_count=0;
           MRUProfile[i]->filename=NULL;
           MRUProfile[i]->encoding=ENCODING_ANSI;
           ZeroMemory(&MRUProfile[i]->LastWriteTime, sizeof(FILETIME));
+          MRUProfile[i]->FileSize=0;
+          MRUProfile[i]->LastCheck=0;
        }
+    }
 
     if (!filename)
 	filename = wininiW;
@@ -777,6 +1041,27 @@ static BOOL PROFILE_Open( LPCWSTR filename, BOOL write_access )
         
     TRACE("path: %s\n", debugstr_w(buffer));
 
+    /* a cached profile that is read from doesn't need to be opened as long as it's unchanged */
+    if (!write_access)
+    {
+        for(i=0;i<profile_cache_size;i++)
+        {
+            if (!MRUProfile[i]->filename || strcmpiW( buffer, MRUProfile[i]->filename )) continue;
+            if (!PROFILE_IsCurrent( MRUProfile[i] )) break;
+
+            TRACE("(%s): already opened, unchanged (mru=%d)\n", debugstr_w(buffer), i);
+            if(i)
+            {
+                PROFILE_FlushFile();
+                tempProfile=MRUProfile[i];
+                for(j=i;j>0;j--)
+                    MRUProfile[j]=MRUProfile[j-1];
+                CurProfile=tempProfile;
+            }
+            return TRUE;
+        }
+    }
+
     hFile = CreateFileW(buffer, GENERIC_READ | (write_access ? GENERIC_WRITE : 0),
                         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
@@ -787,7 +1072,7 @@ static BOOL PROFILE_Open( LPCWSTR filename, BOOL write_access )
         return FALSE;
     }
 
-    for(i=0;i<N_CACHED_PROFILES;i++)
+    for(i=0;i<profile_cache_size;i++)
     {
         if ((MRUProfile[i]->filename && !strcmpiW( buffer, MRUProfile[i]->filename )))
         {
@@ -812,10 +1097,13 @@ static BOOL PROFILE_Open( LPCWSTR filename, BOOL write_access )
                 {
                     TRACE("(%s): already opened, needs refreshing (mru=%d)\n",
                           debugstr_w(buffer), i);
+                    PROFILE_FreeIndex(CurProfile);
                     PROFILE_Free(CurProfile->section);
                     CurProfile->section = PROFILE_Load(hFile, &CurProfile->encoding);
                     CurProfile->LastWriteTime = LastWriteTime;
+                    CurProfile->FileSize = GetFileSize(hFile, NULL);
                 }
+                CurProfile->LastCheck = GetTickCount();
                 CloseHandle(hFile);
                 return TRUE;
             }
@@ -828,10 +1116,10 @@ static BOOL PROFILE_Open( LPCWSTR filename, BOOL write_access )
     PROFILE_FlushFile();
 
     /* Make the oldest profile the current one only in order to get rid of it */
-    if(i==N_CACHED_PROFILES)
+    if(i==profile_cache_size)
       {
-       tempProfile=MRUProfile[N_CACHED_PROFILES-1];
-       for(i=N_CACHED_PROFILES-1;i>0;i--)
+       tempProfile=MRUProfile[profile_cache_size-1];
+       for(i=profile_cache_size-1;i>0;i--)
           MRUProfile[i]=MRUProfile[i-1];
        CurProfile=tempProfile;
       }
@@ -845,6 +1133,8 @@ static BOOL PROFILE_Open( LPCWSTR filename, BOOL write_access )
     {
         CurProfile->section = PROFILE_Load(hFile, &CurProfile->encoding);
         GetFileTime(hFile, NULL, NULL, &CurProfile->LastWriteTime);
+        CurProfile->FileSize = GetFileSize(hFile, NULL);
+        CurProfile->LastCheck = GetTickCount();
         CloseHandle(hFile);
     }
     else
@@ -2380,6 +2380,43 @@ BOOL WINAPI GetQueuedCompletionStatus( HANDLE CompletionPort, LPDWORD lpNumberOf
 }
 
 
+/* GetQueuedCompletionStatusEx fills the entries in place */
+C_ASSERT( sizeof(FILE_IO_COMPLETION_INFORMATION) == sizeof(OVERLAPPED_ENTRY) );
+
+/******************************************************************************
+ *		GetQueuedCompletionStatusEx (KERNEL32.@)
+ */
+BOOL WINAPI GetQueuedCompletionStatusEx( HANDLE port, OVERLAPPED_ENTRY *entries, ULONG count,
+                                         ULONG *written, DWORD timeout, BOOL alertable )
+{
+    FILE_IO_COMPLETION_INFORMATION *info = (FILE_IO_COMPLETION_INFORMATION *)entries;
+    LARGE_INTEGER time;
+    NTSTATUS status;
+    ULONG i;
+
+    TRACE("%p %p %u %p %u %u\n", port, entries, count, written, timeout, alertable);
+
+    status = NtRemoveIoCompletionEx( port, info, count, written, get_nt_timeout( &time, timeout ), alertable );
+    if (status == STATUS_SUCCESS)
+    {
+        for (i = 0; i < *written; i++)
+        {
+            ULONG_PTR information = info[i].IoStatusBlock.Information;
+            NTSTATUS io_status = info[i].IoStatusBlock.u.Status;
+
+            entries[i].Internal = io_status;
+            entries[i].dwNumberOfBytesTransferred = information;
+        }
+        return TRUE;
+    }
+
+    if (status == STATUS_TIMEOUT) SetLastError( WAIT_TIMEOUT );
+    else if (status == STATUS_USER_APC) SetLastError( WAIT_IO_COMPLETION );
+    else SetLastError( RtlNtStatusToDosError(status) );
+    return FALSE;
+}
+
+
 /******************************************************************************
  *		PostQueuedCompletionStatus (KERNEL32.@)
  */
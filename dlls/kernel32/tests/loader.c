@@ -2003,6 +2003,138 @@ static void test_import_resolution(void)
     }
 }
 
+struct relocated_data
+{
+    ULONG_PTR ptr;
+    char str[16];
+    IMAGE_BASE_RELOCATION reloc;
+    WORD entries[2];
+};
+
+static void check_relocated_image( HMODULE mod )
+{
+    struct relocated_data *data = (struct relocated_data *)((char *)mod + page_size);
+
+    ok( data->ptr == (ULONG_PTR)data->str, "wrong relocated pointer %p instead of %p\n",
+        (void *)data->ptr, data->str );
+    ok( !strcmp( data->str, "hello world" ), "wrong data '%s'\n", data->str );
+}
+
+static void child_relocated_image( const char *dll_name, const char *parent_base )
+{
+    HMODULE mod;
+    void *reserved, *parent = NULL;
+
+    reserved = VirtualAlloc( (void *)0x12340000, page_size, MEM_RESERVE, PAGE_NOACCESS );
+    ok( reserved == (void *)0x12340000, "failed to reserve preferred base err %u\n", GetLastError() );
+
+    mod = LoadLibraryA( dll_name );
+    ok( mod != NULL, "failed to load err %u\n", GetLastError() );
+    if (!mod) return;
+    ok( mod != (HMODULE)0x12340000, "loaded at preferred base\n" );
+    sscanf( parent_base, "%p", &parent );
+    if (mod == parent)
+        trace( "loaded at the same address as the parent process\n" );
+    check_relocated_image( mod );
+    FreeLibrary( mod );
+    VirtualFree( reserved, 0, MEM_RELEASE );
+}
+
+static void test_relocated_image(void)
+{
+    char temp_path[MAX_PATH], dll_name[MAX_PATH], cmdline[MAX_PATH * 2];
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si = { sizeof(si) };
+    struct relocated_data data;
+    IMAGE_NT_HEADERS nt;
+    IMAGE_SECTION_HEADER section;
+    HMODULE mod;
+    HANDLE hfile;
+    void *reserved;
+    char **argv;
+    DWORD dummy;
+    BOOL ret;
+
+#define DATA_RVA(ptr) (page_size + ((char *)(ptr) - (char *)&data))
+    nt = nt_header_template;
+    nt.FileHeader.NumberOfSections = 1;
+    nt.FileHeader.SizeOfOptionalHeader = sizeof(IMAGE_OPTIONAL_HEADER);
+    nt.FileHeader.Characteristics = IMAGE_FILE_EXECUTABLE_IMAGE | IMAGE_FILE_DLL;
+    nt.OptionalHeader.SectionAlignment = page_size;
+    nt.OptionalHeader.FileAlignment = 0x200;
+    nt.OptionalHeader.ImageBase = 0x12340000;
+    nt.OptionalHeader.SizeOfImage = 2 * page_size;
+    nt.OptionalHeader.SizeOfHeaders = nt.OptionalHeader.FileAlignment;
+    nt.OptionalHeader.NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+    memset( nt.OptionalHeader.DataDirectory, 0, sizeof(nt.OptionalHeader.DataDirectory) );
+    nt.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC].Size = sizeof(data.reloc) + sizeof(data.entries);
+    nt.OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC].VirtualAddress = DATA_RVA( &data.reloc );
+
+    memset( &data, 0, sizeof(data) );
+    data.ptr = nt.OptionalHeader.ImageBase + DATA_RVA( data.str );
+    strcpy( data.str, "hello world" );
+    data.reloc.VirtualAddress = page_size;
+    data.reloc.SizeOfBlock = sizeof(data.reloc) + sizeof(data.entries);
+#ifdef _WIN64
+    data.entries[0] = (IMAGE_REL_BASED_DIR64 << 12) | (DATA_RVA( &data.ptr ) - page_size);
+#else
+    data.entries[0] = (IMAGE_REL_BASED_HIGHLOW << 12) | (DATA_RVA( &data.ptr ) - page_size);
+#endif
+
+    GetTempPathA(MAX_PATH, temp_path);
+    GetTempFileNameA(temp_path, "ldr", 0, dll_name);
+
+    hfile = CreateFileA(dll_name, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, 0, 0);
+    ok( hfile != INVALID_HANDLE_VALUE, "creation failed\n" );
+
+    memset( &section, 0, sizeof(section) );
+    memcpy( section.Name, ".rdata", sizeof(".rdata") );
+    section.PointerToRawData = nt.OptionalHeader.FileAlignment;
+    section.VirtualAddress = nt.OptionalHeader.SectionAlignment;
+    section.Misc.VirtualSize = sizeof(data);
+    section.SizeOfRawData = sizeof(data);
+    section.Characteristics = IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ;
+
+    WriteFile(hfile, &dos_header, sizeof(dos_header), &dummy, NULL);
+    WriteFile(hfile, &nt, sizeof(nt), &dummy, NULL);
+    WriteFile(hfile, &section, sizeof(section), &dummy, NULL);
+
+    SetFilePointer( hfile, section.PointerToRawData, NULL, SEEK_SET );
+    WriteFile(hfile, &data, sizeof(data), &dummy, NULL);
+
+    CloseHandle( hfile );
+#undef DATA_RVA
+
+    /* block the preferred base in both processes, the child maps the image while the parent has it loaded */
+    reserved = VirtualAlloc( (void *)0x12340000, page_size, MEM_RESERVE, PAGE_NOACCESS );
+    ok( reserved == (void *)0x12340000, "failed to reserve preferred base err %u\n", GetLastError() );
+
+    mod = LoadLibraryA( dll_name );
+    ok( mod != NULL, "failed to load err %u\n", GetLastError() );
+    if (mod)
+    {
+        ok( mod != (HMODULE)0x12340000, "loaded at preferred base\n" );
+        check_relocated_image( mod );
+
+        winetest_get_mainargs( &argv );
+        sprintf( cmdline, "\"%s\" loader relocated %s %p", argv[0], dll_name, mod );
+        ret = CreateProcessA( argv[0], cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi );
+        ok( ret, "CreateProcess(%s) error %d\n", cmdline, GetLastError() );
+        if (ret)
+        {
+            winetest_wait_child_process( pi.hProcess );
+            CloseHandle( pi.hThread );
+            CloseHandle( pi.hProcess );
+        }
+
+        /* the image is still correct after the child is gone */
+        check_relocated_image( mod );
+        FreeLibrary( mod );
+    }
+    VirtualFree( reserved, 0, MEM_RELEASE );
+    DeleteFileA( dll_name );
+}
+
 #define MAX_COUNT 10
 static HANDLE attached_thread[MAX_COUNT];
 static DWORD attached_thread_count;
@@ -3586,6 +3718,11 @@ START_TEST(loader)
         *child_failures = -1;
 
     argc = winetest_get_mainargs(&argv);
+    if (argc > 4 && !strcmp(argv[2], "relocated"))
+    {
+        child_relocated_image(argv[3], argv[4]);
+        return;
+    }
     if (argc > 4)
     {
         test_dll_phase = atoi(argv[4]);
@@ -3599,6 +3736,7 @@ START_TEST(loader)
     test_ImportDescriptors();
     test_section_access();
     test_import_resolution();
+    test_relocated_image();
     test_ExitProcess();
     test_InMemoryOrderModuleList();
 }
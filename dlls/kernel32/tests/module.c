@@ -303,6 +303,44 @@ static void testGetProcAddress_Wrong(void)
     ok( GetLastError() == ERROR_MOD_NOT_FOUND, "Expected ERROR_MOD_NOT_FOUND, got %d\n", GetLastError() );
 }
 
+static void testGetModuleHandle_names(void)
+{
+    HMODULE kernel32 = GetModuleHandleA("kernel32.dll"), hModule;
+    FARPROC fp;
+
+    hModule = GetModuleHandleA("KERNEL32");
+    ok( hModule == kernel32, "got %p, expected %p\n", hModule, kernel32 );
+    hModule = GetModuleHandleA("kErNeL32.DlL");
+    ok( hModule == kernel32, "got %p, expected %p\n", hModule, kernel32 );
+
+    SetLastError(0xdeadbeef);
+    hModule = GetModuleHandleA("kernel32.dll.dll");
+    ok( !hModule, "kernel32.dll.dll should not be found\n");
+    ok( GetLastError() == ERROR_MOD_NOT_FOUND, "Expected ERROR_MOD_NOT_FOUND, got %d\n", GetLastError() );
+
+    SetLastError(0xdeadbeef);
+    fp = GetProcAddress(kernel32, "non_ex_call");
+    ok( !fp, "non_ex_call should not be found\n");
+    ok( GetLastError() == ERROR_PROC_NOT_FOUND, "Expected ERROR_PROC_NOT_FOUND, got %d\n", GetLastError() );
+}
+
+static void testGetProcAddress_forward(void)
+{
+    HMODULE kernel32 = GetModuleHandleA("kernel32.dll"), ntdll = GetModuleHandleA("ntdll.dll");
+    FARPROC fp, expect;
+    int i;
+
+    expect = GetProcAddress(ntdll, "RtlAllocateHeap");
+    ok( expect != NULL, "RtlAllocateHeap not found\n");
+
+    /* the second lookup may use a cached result */
+    for (i = 0; i < 2; i++)
+    {
+        fp = GetProcAddress(kernel32, "HeapAlloc");
+        ok( fp == expect, "%d: got %p, expected %p\n", i, fp, expect );
+    }
+}
+
 static void testLoadLibraryEx(void)
 {
     CHAR path[MAX_PATH];
@@ -1040,6 +1078,8 @@ START_TEST(module)
     testNestedLoadLibraryA();
     testLoadLibraryA_Wrong();
     testGetProcAddress_Wrong();
+    testGetModuleHandle_names();
+    testGetProcAddress_forward();
     testLoadLibraryEx();
     test_LoadLibraryEx_search_flags();
     testGetModuleHandleEx();
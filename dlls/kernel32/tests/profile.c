@@ -534,6 +534,57 @@ static void create_test_file(LPCSTR name, LPCSTR data, DWORD size)
     CloseHandle(hfile);
 }
 
+static void test_profile_many_keys(void)
+{
+    static const char testfile[] = ".\\winetest5.ini";
+    static const char contents[] = "[dup]\nkey=first\n[Dup]\nkey=second\n";
+    char key[16], value[16], buf[16];
+    DWORD res;
+    int i;
+
+    DeleteFileA(testfile);
+    create_test_file(testfile, contents, sizeof(contents) - 1);
+
+    /* the first of duplicate sections is used */
+    res = GetPrivateProfileStringA("DUP", "key", "", buf, sizeof(buf), testfile);
+    ok(res == 5 && !strcmp(buf, "first"), "got %u %s\n", res, buf);
+
+    for (i = 0; i < 300; i++)
+    {
+        sprintf(key, "key%d", i);
+        sprintf(value, "%d", i);
+        res = WritePrivateProfileStringA(i % 2 ? "odd" : "even", key, value, testfile);
+        ok(res, "WritePrivateProfileString failed, error %u\n", GetLastError());
+    }
+    for (i = 0; i < 300; i += 3)
+    {
+        sprintf(key, "KEY%d", i);
+        res = WritePrivateProfileStringA(i % 2 ? "ODD" : "EVEN", key, NULL, testfile);
+        ok(res, "WritePrivateProfileString failed, error %u\n", GetLastError());
+    }
+    for (i = 0; i < 300; i++)
+    {
+        sprintf(key, " key%d ", i);
+        res = GetPrivateProfileIntA(i % 2 ? " odd " : " even ", key, -1, testfile);
+        ok(res == (i % 3 ? i : -1), "%d: got %d\n", i, res);
+        res = GetPrivateProfileIntA(i % 2 ? "even" : "odd", key, -1, testfile);
+        ok(res == -1, "%d: got %d\n", i, res);
+    }
+
+    res = WritePrivateProfileStringA("odd", NULL, NULL, testfile);
+    ok(res, "WritePrivateProfileString failed, error %u\n", GetLastError());
+    res = GetPrivateProfileIntA("odd", "key1", -1, testfile);
+    ok(res == -1, "got %d\n", res);
+    res = WritePrivateProfileStringA("odd", "key1", "5", testfile);
+    ok(res, "WritePrivateProfileString failed, error %u\n", GetLastError());
+    res = GetPrivateProfileIntA("odd", "key1", -1, testfile);
+    ok(res == 5, "got %d\n", res);
+    res = GetPrivateProfileIntA("even", "key2", -1, testfile);
+    ok(res == 2, "got %d\n", res);
+
+    DeleteFileA(testfile);
+}
+
 static BOOL emptystr_ok(CHAR emptystr[MAX_PATH])
 {
     int i;
@@ -1184,6 +1235,7 @@ START_TEST(profile)
     test_profile_existing();
     test_profile_delete_on_close();
     test_profile_refresh();
+    test_profile_many_keys();
     test_profile_directory_readonly();
     test_GetPrivateProfileString(
         "[section1]\r\n"
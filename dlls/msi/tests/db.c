@@ -2179,6 +2179,30 @@ static void test_where(void)
     MsiViewClose(view);
     MsiCloseHandle(view);
 
+    /* rows inserted before the existing ones after a lookup */
+    query = "SELECT * FROM `Media` WHERE `LastSequence` = 2";
+    r = do_query(hdb, query, &rec);
+    ok(r == ERROR_SUCCESS, "query failed: %d\n", r);
+    ok( check_record( rec, 4, "two.cab"), "wrong cabinet\n");
+    MsiCloseHandle( rec );
+
+    r = run_query( hdb, 0, "INSERT INTO `Media` "
+            "( `DiskId`, `LastSequence`, `DiskPrompt`, `Cabinet`, `VolumeLabel`, `Source` ) "
+            "VALUES ( 0, 5, '', 'minus.cab', '', '' )" );
+    ok( r == S_OK, "cannot add file to the Media table: %d\n", r );
+
+    query = "SELECT * FROM `Media` WHERE `LastSequence` = 2";
+    r = do_query(hdb, query, &rec);
+    ok(r == ERROR_SUCCESS, "query failed: %d\n", r);
+    ok( check_record( rec, 4, "two.cab"), "wrong cabinet\n");
+    MsiCloseHandle( rec );
+
+    query = "SELECT * FROM `Media` WHERE `LastSequence` = 5";
+    r = do_query(hdb, query, &rec);
+    ok(r == ERROR_SUCCESS, "query failed: %d\n", r);
+    ok( check_record( rec, 4, "minus.cab"), "wrong cabinet\n");
+    MsiCloseHandle( rec );
+
     MsiCloseHandle( hdb );
     DeleteFileA(msifile);
 }
@@ -3998,6 +4022,69 @@ static void test_join(void)
     ok( r == ERROR_BAD_QUERY_SYNTAX,
         "Expected ERROR_BAD_QUERY_SYNTAX, got %d\n", r );
 
+    /* join with the values to look up passed as parameters */
+    query = "SELECT `Component`.`ComponentId`, `FeatureComponents`.`Feature_` "
+            "FROM `Component`, `FeatureComponents` "
+            "WHERE `Component`.`Component` = `FeatureComponents`.`Component_` "
+            "AND `FeatureComponents`.`Feature_` = ?";
+    r = MsiDatabaseOpenViewA(hdb, query, &hview);
+    ok( r == ERROR_SUCCESS, "failed to open view: %d\n", r );
+
+    hrec = MsiCreateRecord(1);
+    MsiRecordSetStringA(hrec, 1, "nasalis");
+    r = MsiViewExecute(hview, hrec);
+    ok( r == ERROR_SUCCESS, "failed to execute view: %d\n", r );
+    MsiCloseHandle(hrec);
+
+    i = 0;
+    data_correct = TRUE;
+    while ((r = MsiViewFetch(hview, &hrec)) == ERROR_SUCCESS)
+    {
+        size = MAX_PATH;
+        r = MsiRecordGetStringA( hrec, 1, buf, &size );
+        ok( r == ERROR_SUCCESS, "failed to get record string: %d\n", r );
+        if (lstrcmpA( buf, "septum" ) && lstrcmpA( buf, "ramus" ))
+            data_correct = FALSE;
+
+        size = MAX_PATH;
+        r = MsiRecordGetStringA( hrec, 2, buf, &size );
+        ok( r == ERROR_SUCCESS, "failed to get record string: %d\n", r );
+        if (lstrcmpA( buf, "nasalis" ))
+            data_correct = FALSE;
+
+        i++;
+        MsiCloseHandle(hrec);
+    }
+    ok( data_correct, "data returned in the wrong order\n");
+    ok( i == 2, "Expected 2 rows, got %d\n", i );
+    ok( r == ERROR_NO_MORE_ITEMS, "expected no more items: %d\n", r );
+
+    MsiViewClose(hview);
+    MsiCloseHandle(hview);
+
+    query = "SELECT * FROM `One`, `Two` WHERE `Two`.`C` = ? AND `One`.`A` = 1";
+    r = MsiDatabaseOpenViewA(hdb, query, &hview);
+    ok( r == ERROR_SUCCESS, "failed to open view: %d\n", r );
+
+    hrec = MsiCreateRecord(1);
+    MsiRecordSetInteger(hrec, 1, 5);
+    r = MsiViewExecute(hview, hrec);
+    ok( r == ERROR_SUCCESS, "failed to execute view: %d\n", r );
+    MsiCloseHandle(hrec);
+
+    r = MsiViewFetch(hview, &hrec);
+    ok( r == ERROR_SUCCESS, "failed to fetch view: %d\n", r );
+    ok( MsiRecordGetInteger(hrec, 1) == 1, "got %d\n", MsiRecordGetInteger(hrec, 1) );
+    ok( MsiRecordGetInteger(hrec, 3) == 5, "got %d\n", MsiRecordGetInteger(hrec, 3) );
+    ok( MsiRecordGetInteger(hrec, 4) == 6, "got %d\n", MsiRecordGetInteger(hrec, 4) );
+    MsiCloseHandle(hrec);
+
+    r = MsiViewFetch(hview, &hrec);
+    ok( r == ERROR_NO_MORE_ITEMS, "expected no more items: %d\n", r );
+
+    MsiViewClose(hview);
+    MsiCloseHandle(hview);
+
     /* try updating a row in a join table */
     query = "SELECT `Component`.`ComponentId`, `FeatureComponents`.`Feature_` "
             "FROM `Component`, `FeatureComponents` "
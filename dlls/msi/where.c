@@ -52,6 +52,10 @@ typedef struct tagJOINTABLE
     UINT col_count;
     UINT row_count;
     UINT table_index;
+    UINT lookup_column;            /* column matched through find_matching_rows, 0 to scan all rows */
+    UINT lookup_type;              /* expression type of lookup_column */
+    const struct expr *lookup_key; /* value the column is compared to */
+    UINT lookup_field;             /* record field of the value if lookup_key is a wildcard */
 } JOINTABLE;
 
 typedef struct tagMSIORDERINFO
@@ -599,16 +603,84 @@ static UINT WHERE_evaluate( MSIWHEREVIEW *wv, const UINT rows[],
     return ERROR_SUCCESS;
 }
 
+static UINT lookup_string_id( MSIWHEREVIEW *wv, const WCHAR *str, UINT *id )
+{
+    /* the empty string is never stored in the string table */
+    *id = 0;
+    if (str && *str && msi_string2id( wv->db->strings, str, -1, id ) != ERROR_SUCCESS)
+        return ERROR_NO_MORE_ITEMS;
+    return ERROR_SUCCESS;
+}
+
+/* computes the raw column value that rows of the table have to hold to
+ * satisfy the lookup condition, ERROR_NO_MORE_ITEMS if none can */
+static UINT lookup_key_value( MSIWHEREVIEW *wv, const JOINTABLE *table, const UINT rows[],
+                              MSIRECORD *record, UINT *val )
+{
+    const struct expr *key = table->lookup_key;
+    UINT r;
+
+    switch (key->type)
+    {
+    case EXPR_COL_NUMBER:
+    case EXPR_COL_NUMBER32:
+    case EXPR_COL_NUMBER_STRING:
+        r = expr_fetch_value(&key->u.column, rows, val);
+        return r == ERROR_CONTINUE ? ERROR_FUNCTION_FAILED : r;
+
+    case EXPR_SVAL:
+        return lookup_string_id(wv, key->u.sval, val);
+
+    case EXPR_WILDCARD:
+        if (table->lookup_type == EXPR_COL_NUMBER_STRING)
+            return lookup_string_id(wv, MSI_RecordGetString(record, table->lookup_field), val);
+        *val = MSI_RecordGetInteger(record, table->lookup_field);
+        break;
+
+    case EXPR_UVAL:
+        *val = key->u.uval;
+        break;
+
+    default:
+        ERR("Invalid expression type\n");
+        return ERROR_FUNCTION_FAILED;
+    }
+
+    /* integers are stored with an offset, see WHERE_evaluate */
+    *val += table->lookup_type == EXPR_COL_NUMBER32 ? 0x80000000 : 0x8000;
+    return ERROR_SUCCESS;
+}
+
 static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
                              UINT table_rows[] )
 {
-    UINT r = ERROR_FUNCTION_FAILED;
+    JOINTABLE *table = *tables;
+    MSIITERHANDLE handle = 0;
+    UINT r = ERROR_SUCCESS, key = 0, row = 0;
     INT val;
 
-    for (table_rows[(*tables)->table_index] = 0;
-         table_rows[(*tables)->table_index] < (*tables)->row_count;
-         table_rows[(*tables)->table_index]++)
+    if (table->lookup_column)
     {
+        r = lookup_key_value(wv, table, table_rows, record, &key);
+        if (r == ERROR_NO_MORE_ITEMS)
+            return ERROR_SUCCESS;
+        if (r != ERROR_SUCCESS)
+            return r;
+    }
+
+    for (;;)
+    {
+        if (table->lookup_column)
+        {
+            if (table->view->ops->find_matching_rows(table->view, table->lookup_column,
+                                                     key, &row, &handle) != ERROR_SUCCESS)
+                break;
+        }
+        else if (row >= table->row_count)
+            break;
+
+        table_rows[table->table_index] = row++;
+
         val = 0;
         wv->rec_index = 0;
         r = WHERE_evaluate( wv, table_rows, wv->cond, &val, record );
@@ -630,7 +702,7 @@ static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **ta
             }
         }
     }
-    table_rows[(*tables)->table_index] = INVALID_ROW_INDEX;
+    table_rows[table->table_index] = INVALID_ROW_INDEX;
     return r;
 }
 
@@ -763,6 +835,145 @@ static JOINTABLE **ordertables( MSIWHEREVIEW *wv )
     return tables;
 }
 
+static BOOL is_bound( JOINTABLE **ordered_tables, UINT count, const JOINTABLE *table )
+{
+    UINT i;
+
+    for (i = 0; i < count; i++)
+        if (ordered_tables[i] == table)
+            return TRUE;
+    return FALSE;
+}
+
+static BOOL is_column( const struct expr *expr )
+{
+    return expr->type == EXPR_COL_NUMBER || expr->type == EXPR_COL_NUMBER32 ||
+           expr->type == EXPR_COL_NUMBER_STRING;
+}
+
+/* checks if "column = key" can be used to look up the rows of the table
+ * instead of scanning them; the key must be known once the tables evaluated
+ * before this one have a current row */
+static BOOL set_lookup( JOINTABLE *table, JOINTABLE **ordered_tables, UINT count,
+                        const struct expr *column, const struct expr *key, UINT field )
+{
+    UINT type;
+
+    if (!is_column(column) || column->u.column.parsed.table != table)
+        return FALSE;
+
+    if (!table->view->ops->find_matching_rows)
+        return FALSE;
+    if (table->view->ops->get_column_info(table->view, column->u.column.parsed.column,
+                                          NULL, &type, NULL, NULL) != ERROR_SUCCESS ||
+        MSITYPE_IS_BINARY(type))
+        return FALSE;
+
+    switch (key->type)
+    {
+    case EXPR_COL_NUMBER:
+    case EXPR_COL_NUMBER32:
+    case EXPR_COL_NUMBER_STRING:
+        /* raw values are only comparable for columns of the same type */
+        if (key->type != column->type || !is_bound(ordered_tables, count, key->u.column.parsed.table))
+            return FALSE;
+        break;
+    case EXPR_UVAL:
+        if (column->type == EXPR_COL_NUMBER_STRING)
+            return FALSE;
+        break;
+    case EXPR_SVAL:
+        if (column->type != EXPR_COL_NUMBER_STRING)
+            return FALSE;
+        break;
+    case EXPR_WILDCARD:
+        break;
+    default:
+        return FALSE;
+    }
+
+    table->lookup_column = column->u.column.parsed.column;
+    table->lookup_type = column->type;
+    table->lookup_key = key;
+    table->lookup_field = field;
+    return TRUE;
+}
+
+/* looks for an equality in the top level conjunction of the condition that
+ * selects the rows of the table; wildcards counts the wildcards preceding
+ * expr in evaluation order, so that they can be mapped to record fields */
+static void find_lookup( JOINTABLE *table, JOINTABLE **ordered_tables, UINT count,
+                         const struct expr *expr, BOOL conjunct, UINT *wildcards )
+{
+    const struct expr *left, *right;
+    UINT field;
+
+    switch (expr->type)
+    {
+    case EXPR_WILDCARD:
+        (*wildcards)++;
+        return;
+
+    case EXPR_COMPLEX:
+    case EXPR_STRCMP:
+        left = expr->u.expr.left;
+        right = expr->u.expr.right;
+        if (conjunct && expr->u.expr.op == OP_EQ && !table->lookup_column)
+        {
+            field = *wildcards + 1;
+            if (!set_lookup(table, ordered_tables, count, left, right,
+                            field + (left->type == EXPR_WILDCARD)))
+                set_lookup(table, ordered_tables, count, right, left, field);
+        }
+        conjunct = conjunct && expr->u.expr.op == OP_AND;
+        find_lookup(table, ordered_tables, count, left, conjunct, wildcards);
+        find_lookup(table, ordered_tables, count, right, conjunct, wildcards);
+        return;
+
+    default:
+        return;
+    }
+}
+
+/* decides for each table whether its rows are scanned or looked up through
+ * the column hash tables, given the order in which they are evaluated */
+static void plan_lookups( MSIWHEREVIEW *wv, JOINTABLE **ordered_tables )
+{
+    UINT i, wildcards;
+
+    for (i = 0; ordered_tables[i]; i++)
+    {
+        JOINTABLE *table = ordered_tables[i];
+        LPCWSTR table_name = NULL;
+
+        table->lookup_column = 0;
+        table->lookup_key = NULL;
+        if (wv->cond)
+        {
+            wildcards = 0;
+            find_lookup(table, ordered_tables, i, wv->cond, TRUE, &wildcards);
+        }
+
+        if (!TRACE_ON(msidb))
+            continue;
+
+        table->view->ops->get_column_info(table->view, 1, NULL, NULL, NULL, &table_name);
+        if (!table->lookup_column)
+            TRACE("%p: %u: scan %s, %u rows\n", wv, i, debugstr_w(table_name), table->row_count);
+        else if (table->lookup_key->type == EXPR_WILDCARD)
+            TRACE("%p: %u: look up %s column %u from record field %u\n", wv, i,
+                  debugstr_w(table_name), table->lookup_column, table->lookup_field);
+        else if (is_column(table->lookup_key))
+            TRACE("%p: %u: look up %s column %u from table %u column %u\n", wv, i,
+                  debugstr_w(table_name), table->lookup_column,
+                  table->lookup_key->u.column.parsed.table->table_index,
+                  table->lookup_key->u.column.parsed.column);
+        else
+            TRACE("%p: %u: look up %s column %u from a constant\n", wv, i,
+                  debugstr_w(table_name), table->lookup_column);
+    }
+}
+
 static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
 {
     MSIWHEREVIEW *wv = (MSIWHEREVIEW*)view;
@@ -799,6 +1010,7 @@ static UINT WHERE_execute( struct tagMSIVIEW *view, MSIRECORD *record )
     while ((table = table->next));
 
     ordered_tables = ordertables( wv );
+    plan_lookups( wv, ordered_tables );
 
     rows = msi_alloc( wv->table_count * sizeof(*rows) );
     for (i = 0; i < wv->table_count; i++)
@@ -1232,7 +1444,7 @@ UINT WHERE_CreateView( MSIDATABASE *db, MSIVIEW **view, LPWSTR tables,
         if ((ptr = strchrW(tables, ' ')))
             *ptr = '\0';
 
-        table = msi_alloc(sizeof(JOINTABLE));
+        table = msi_alloc_zero(sizeof(JOINTABLE));
         if (!table)
         {
             r = ERROR_OUTOFMEMORY;
@@ -82,6 +82,10 @@ static char utf16_bom[2] = { 0xff, 0xfe };
 #define MSVCRT_FD_BLOCK_SIZE 32
 
 #define MSVCRT_INTERNAL_BUFSIZ 4096
+#define MSVCRT_MAX_READ_BUFSIZ  0x10000
+
+/* spin a little before blocking on a contended stream or fd lock */
+#define MSVCRT_LOCK_SPINCOUNT   4000
 
 /* ioinfo structure size is different in msvcrXX.dll's */
 typedef struct {
@@ -257,7 +261,7 @@ static inline void init_ioinfo_cs(ioinfo *info)
     if(!(info->exflag & EF_CRIT_INIT)) {
         LOCK_FILES();
         if(!(info->exflag & EF_CRIT_INIT)) {
-            InitializeCriticalSection(&info->crit);
+            InitializeCriticalSectionAndSpinCount(&info->crit, MSVCRT_LOCK_SPINCOUNT);
             info->exflag |= EF_CRIT_INIT;
         }
         UNLOCK_FILES();
@@ -460,7 +464,7 @@ static MSVCRT_FILE* msvcrt_alloc_fp(void)
       {
           if (file<MSVCRT__iob || file>=MSVCRT__iob+_IOB_ENTRIES)
           {
-              InitializeCriticalSection(&((file_crit*)file)->crit);
+              InitializeCriticalSectionAndSpinCount(&((file_crit*)file)->crit, MSVCRT_LOCK_SPINCOUNT);
               ((file_crit*)file)->crit.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": file_crit.crit");
           }
           MSVCRT_stream_idx++;
@@ -702,6 +706,30 @@ static BOOL msvcrt_alloc_buffer(MSVCRT_FILE* file)
     return TRUE;
 }
 
+/* INTERNAL: Grow the internal buffer of a read-only stream that is read sequentially
+ * Only call this function when the buffer is empty */
+static void msvcrt_grow_read_buffer(MSVCRT_FILE* file)
+{
+    char *buf;
+
+    if((file->_flag & (MSVCRT__IOMYBUF | MSVCRT__IORW)) != MSVCRT__IOMYBUF
+            || file->_bufsiz >= MSVCRT_MAX_READ_BUFSIZ)
+        return;
+
+    /* the previous fill has to be mostly consumed, seeking resets _ptr */
+    if(file->_ptr - file->_base <= file->_bufsiz / 2)
+        return;
+
+    buf = MSVCRT_malloc(file->_bufsiz * 2);
+    if(!buf)
+        return;
+
+    TRACE("growing buffer of %p to %d\n", file, file->_bufsiz * 2);
+    MSVCRT_free(file->_base);
+    file->_ptr = file->_base = buf;
+    file->_bufsiz *= 2;
+}
+
 /* INTERNAL: Allocate temporary buffer for stdout and stderr */
 static BOOL add_std_buffer(MSVCRT_FILE *file)
 {
@@ -2739,6 +2767,27 @@ static int read_utf8(ioinfo *fdinfo, MSVCRT_wchar_t *buf, unsigned int count)
     return num_read*2;
 }
 
+/* INTERNAL: find the first \r or ^Z in a text mode buffer, a machine word at a time */
+static DWORD find_text_special(const char *buf, DWORD len)
+{
+    static const ULONG_PTR ones = ~(ULONG_PTR)0 / 0xff;
+    ULONG_PTR word, cr, eof;
+    DWORD i = 0;
+
+    for(; i + sizeof(word) <= len; i += sizeof(word))
+    {
+        memcpy(&word, buf + i, sizeof(word));
+        cr = word ^ (ones * '\r');
+        eof = word ^ (ones * 0x1a);
+        if((((cr - ones) & ~cr) | ((eof - ones) & ~eof)) & (ones << 7))
+            break;
+    }
+    for(; i < len; i++)
+        if(buf[i] == '\r' || buf[i] == 0x1a)
+            break;
+    return i;
+}
+
 /*********************************************************************
  * (internal) read_i
  *
@@ -2820,6 +2869,20 @@ static int read_i(int fd, ioinfo *fdinfo, void *buf, unsigned int count)
 
             for (i=0, j=0; i<num_read; i+=1+utf16)
             {
+                /* copy runs without \r or ^Z in one go */
+                if (!utf16)
+                {
+                    DWORD run = find_text_special(bufstart+i, num_read-i);
+
+                    if (run)
+                    {
+                        if (i != j) memmove(bufstart+j, bufstart+i, run);
+                        i += run;
+                        j += run;
+                        if (i == num_read) break;
+                    }
+                }
+
                 /* in text mode, a ctrl-z signals EOF */
                 if (bufstart[i]==0x1a && (!utf16 || bufstart[i+1]==0))
                 {
@@ -3704,6 +3767,7 @@ int CDECL MSVCRT__filbuf(MSVCRT_FILE* file)
 
         return c;
     } else {
+        msvcrt_grow_read_buffer(file);
         file->_cnt = MSVCRT__read(file->_file, file->_base, file->_bufsiz);
         if(file->_cnt<=0) {
             file->_flag |= (file->_cnt == 0) ? MSVCRT__IOEOF : MSVCRT__IOERR;
@@ -4317,6 +4381,7 @@ MSVCRT_size_t CDECL MSVCRT__fread_nolock(void *ptr, MSVCRT_size_t size, MSVCRT_s
   {
     int i;
     if (!file->_cnt && rcnt<file->_bufsiz && (file->_flag & (MSVCRT__IOMYBUF | MSVCRT__USERBUF))) {
+      msvcrt_grow_read_buffer(file);
       i = MSVCRT__read(file->_file, file->_base, file->_bufsiz);
       file->_ptr = file->_base;
       if (i != -1) {
@@ -257,8 +257,27 @@ void CDECL _chkesp(void)
 
 static inline void swap(char *l, char *r, MSVCRT_size_t size)
 {
+    ULONG_PTR tmp_word;
+    DWORD tmp_dword;
     char tmp;
 
+    /* elements don't have to be aligned, memcpy compiles to plain moves */
+    if(size == sizeof(DWORD)) {
+        memcpy(&tmp_dword, l, sizeof(DWORD));
+        memcpy(l, r, sizeof(DWORD));
+        memcpy(r, &tmp_dword, sizeof(DWORD));
+        return;
+    }
+
+    while(size >= sizeof(tmp_word)) {
+        memcpy(&tmp_word, l, sizeof(tmp_word));
+        memcpy(l, r, sizeof(tmp_word));
+        memcpy(r, &tmp_word, sizeof(tmp_word));
+        l += sizeof(tmp_word);
+        r += sizeof(tmp_word);
+        size -= sizeof(tmp_word);
+    }
+
     while(size--) {
         tmp = *l;
         *l++ = *r;
@@ -285,36 +304,108 @@ static void small_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
     }
 }
 
+static void heap_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
+        int (CDECL *compar)(void *, const void *, const void *), void *context)
+{
+    MSVCRT_size_t e, i, root, child;
+
+#define X(i) ((char*)base+size*(i))
+    for(i=nmemb/2+nmemb-1; i>0; i--) {
+        /* build the heap first, then move its top to the end of the array */
+        if(i >= nmemb) {
+            root = i-nmemb;
+            e = nmemb;
+        }else {
+            swap(X(0), X(i), size);
+            root = 0;
+            e = i;
+        }
+
+        while((child = 2*root+1) < e) {
+            if(child+1 < e && compar(context, X(child), X(child+1)) < 0)
+                child++;
+            if(compar(context, X(root), X(child)) >= 0)
+                break;
+            swap(X(root), X(child), size);
+            root = child;
+        }
+    }
+#undef X
+}
+
+/* ranges with less elements are sorted with native compatible comparisons only */
+#define SORTED_CHECK_MIN 32
+
+static BOOL is_sorted(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
+        int (CDECL *compar)(void *, const void *, const void *), void *context)
+{
+    char *p, *end = (char*)base + (nmemb-1)*size;
+
+    for(p=base; p<end; p+=size) {
+        if(compar(context, p, p+size) > 0)
+            return FALSE;
+    }
+    return TRUE;
+}
+
 static void quick_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
         int (CDECL *compar)(void *, const void *, const void *), void *context)
 {
     MSVCRT_size_t stack_lo[8*sizeof(MSVCRT_size_t)], stack_hi[8*sizeof(MSVCRT_size_t)];
+    unsigned char stack_depth[8*sizeof(MSVCRT_size_t)];
+    BOOL stack_ordered[8*sizeof(MSVCRT_size_t)];
     MSVCRT_size_t beg, end, lo, hi, med;
-    int stack_pos;
+    int stack_pos, max_depth, depth;
+    BOOL ordered;
+
+    /* switch to heap sort when partitioning goes more than 2*log2(nmemb) levels deep */
+    for(max_depth=0, lo=nmemb; lo>1; lo>>=1)
+        max_depth += 2;
 
     stack_pos = 0;
     stack_lo[stack_pos] = 0;
     stack_hi[stack_pos] = nmemb-1;
+    stack_depth[stack_pos] = 0;
+    stack_ordered[stack_pos] = TRUE;
 
 #define X(i) ((char*)base+size*(i))
     while(stack_pos >= 0) {
         beg = stack_lo[stack_pos];
-        end = stack_hi[stack_pos--];
+        end = stack_hi[stack_pos];
+        depth = stack_depth[stack_pos];
+        ordered = stack_ordered[stack_pos--];
 
         if(end-beg < 8) {
             small_sort(X(beg), end-beg+1, size, compar, context);
             continue;
         }
 
+        /* whole input or a range left untouched by its partition step may be sorted already */
+        if(ordered && end-beg+1 >= SORTED_CHECK_MIN
+                && is_sorted(X(beg), end-beg+1, size, compar, context))
+            continue;
+
+        if(depth >= max_depth) {
+            heap_sort(X(beg), end-beg+1, size, compar, context);
+            continue;
+        }
+
+        ordered = TRUE;
         lo = beg;
         hi = end;
         med = lo + (hi-lo+1)/2;
-        if(compar(context, X(lo), X(med)) > 0)
+        if(compar(context, X(lo), X(med)) > 0) {
             swap(X(lo), X(med), size);
-        if(compar(context, X(lo), X(hi)) > 0)
+            ordered = FALSE;
+        }
+        if(compar(context, X(lo), X(hi)) > 0) {
             swap(X(lo), X(hi), size);
-        if(compar(context, X(med), X(hi)) > 0)
+            ordered = FALSE;
+        }
+        if(compar(context, X(med), X(hi)) > 0) {
             swap(X(med), X(hi), size);
+            ordered = FALSE;
+        }
 
         lo++;
         hi--;
@@ -335,6 +426,7 @@ static void quick_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
                 break;
 
             swap(X(lo), X(hi), size);
+            ordered = FALSE;
             if(hi == med)
                 med = lo;
             lo++;
@@ -347,16 +439,25 @@ static void quick_sort(void *base, MSVCRT_size_t nmemb, MSVCRT_size_t size,
             hi--;
         }
 
+        depth++;
         if(hi-beg >= end-lo) {
             stack_lo[++stack_pos] = beg;
             stack_hi[stack_pos] = hi;
+            stack_depth[stack_pos] = depth;
+            stack_ordered[stack_pos] = ordered;
             stack_lo[++stack_pos] = lo;
             stack_hi[stack_pos] = end;
+            stack_depth[stack_pos] = depth;
+            stack_ordered[stack_pos] = ordered;
         }else {
             stack_lo[++stack_pos] = lo;
             stack_hi[stack_pos] = end;
+            stack_depth[stack_pos] = depth;
+            stack_ordered[stack_pos] = ordered;
             stack_lo[++stack_pos] = beg;
             stack_hi[stack_pos] = hi;
+            stack_depth[stack_pos] = depth;
+            stack_ordered[stack_pos] = ordered;
         }
     }
 #undef X
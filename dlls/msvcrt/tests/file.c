@@ -561,6 +561,57 @@ static void test_readboundary(void)
   ok(strcmp(buf, rbuf) == 0,"CRLF on buffer boundary failure\n");
   }
 
+static void test_readlarge(void)
+{
+  static const int lines = 20000;
+  char *raw, *text, *rbuf;
+  int raw_len = 0, text_len = 0, len, i, c;
+  FILE *fp;
+
+  raw = malloc(lines * 32);
+  text = malloc(lines * 32);
+  rbuf = malloc(lines * 32);
+  for (i = 0; i < lines; i++)
+  {
+      len = sprintf(raw + raw_len, i % 7 ? "%05d abcdefghij\r\n" : "%05d abc\rdefghij\r\n", i);
+      memcpy(text + text_len, raw + raw_len, len - 2);
+      text[text_len + len - 2] = '\n';
+      raw_len += len;
+      text_len += len - 1;
+  }
+
+  fp = fopen("large.tst", "wb");
+  ok(fwrite(raw, 1, raw_len, fp) == raw_len, "fwrite failed\n");
+  fclose(fp);
+
+  fp = fopen("large.tst", "rt");
+  for (i = 0; (c = fgetc(fp)) != EOF && i < text_len; i++)
+      rbuf[i] = c;
+  ok(i == text_len, "read %d chars, expected %d\n", i, text_len);
+  ok(!memcmp(rbuf, text, text_len), "text mode fgetc read wrong data\n");
+  fclose(fp);
+
+  fp = fopen("large.tst", "rt");
+  len = fread(rbuf, 1, 100, fp);
+  len += fread(rbuf + len, 1, text_len - 100, fp);
+  ok(len == text_len, "read %d chars, expected %d\n", len, text_len);
+  ok(!memcmp(rbuf, text, text_len), "text mode fread read wrong data\n");
+  ok(fgetc(fp) == EOF, "expected EOF\n");
+  fclose(fp);
+
+  fp = fopen("large.tst", "rb");
+  for (i = 0; (c = fgetc(fp)) != EOF && i < raw_len; i++)
+      rbuf[i] = c;
+  ok(i == raw_len, "read %d chars, expected %d\n", i, raw_len);
+  ok(!memcmp(rbuf, raw, raw_len), "binary mode fgetc read wrong data\n");
+  fclose(fp);
+
+  unlink("large.tst");
+  free(raw);
+  free(text);
+  free(rbuf);
+}
+
 static void test_fgetc( void )
 {
   char* tempf;
@@ -2630,6 +2681,7 @@ START_TEST(file)
     test_readmode(FALSE); /* binary mode */
     test_readmode(TRUE);  /* ascii mode */
     test_readboundary();
+    test_readlarge();
     test_fgetc();
     test_fputc();
     test_flsbuf();
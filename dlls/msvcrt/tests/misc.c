@@ -502,6 +502,22 @@ static void test_qsort_s(void)
     p_qsort_s(tab, 100, sizeof(int), qsort_comp, NULL);
     for(i=0; i<100; i++)
         ok(tab[i] == i, "data sorted incorrectly on position %d: %d\n", i, tab[i]);
+
+    /* test if sorted and reversed data is sorted correctly */
+    p_qsort_s(tab, 100, sizeof(int), qsort_comp, NULL);
+    for(i=0; i<100; i++)
+        ok(tab[i] == i, "data sorted incorrectly on position %d: %d\n", i, tab[i]);
+
+    for(i=0; i<100; i++) tab[i] = 99-i;
+    p_qsort_s(tab, 100, sizeof(int), qsort_comp, NULL);
+    for(i=0; i<100; i++)
+        ok(tab[i] == i, "data sorted incorrectly on position %d: %d\n", i, tab[i]);
+
+    /* organ pipe data */
+    for(i=0; i<100; i++) tab[i] = i<50 ? 2*i : 199-2*i;
+    p_qsort_s(tab, 100, sizeof(int), qsort_comp, NULL);
+    for(i=0; i<100; i++)
+        ok(tab[i] == i, "data sorted incorrectly on position %d: %d\n", i, tab[i]);
 }
 
 static void test_math_functions(void)
@@ -25,9 +25,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
 #ifdef HAVE_UNISTD_H
 # include <unistd.h>
 #endif
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
 #include <ctype.h>
 
 #include "wine/debug.h"
@@ -45,6 +49,162 @@ static struct __wine_debug_functions default_funcs;
 
 /* ---------------------------------------------------------------------- */
 
+/*
+ * When WINEDEBUGRING is set, debug output isn't written to stderr but kept in
+ * ring buffers inside a shared file mapping named "$WINEDEBUGRING.<unix pid>".
+ * Each thread appends records to a ring it owns exclusively, so no locking
+ * is needed, and the mapping is readable both while the process runs and
+ * after it crashed. tools/dump-debug-ring renders it back to text.
+ */
+
+#define DEBUG_RING_SLOTS     64
+#define DEBUG_RING_SIZE      (256 * 1024)
+#define DEBUG_RING_MAGIC     0x474e4952  /* "RING" */
+#define DEBUG_RECORD_MAGIC   0x47424457  /* "WDBG" */
+#define DEBUG_RECORD_WRAP    0xffffffff  /* record length of the padding at the ring end */
+
+struct debug_ring_header
+{
+    unsigned int magic;          /* DEBUG_RING_MAGIC */
+    unsigned int version;        /* layout version, currently 1 */
+    unsigned int slot_count;     /* number of rings */
+    unsigned int slot_size;      /* size of data in each ring */
+    unsigned int pid;            /* Win32 process id, filled once known */
+    unsigned int unix_pid;       /* Unix process id */
+    unsigned int reserved[2];
+};
+
+struct debug_ring
+{
+    int          owner;          /* thread id of the current owner, 0 if free */
+    int          head;           /* offset in data where the next record goes */
+    int          wrapped;        /* set once the ring wrapped around */
+    unsigned int reserved;
+    char         data[DEBUG_RING_SIZE];
+};
+
+struct debug_record
+{
+    unsigned int magic;          /* DEBUG_RECORD_MAGIC */
+    unsigned int len;            /* length of text following the record */
+    ULONGLONG    time;           /* monotonic time in 100ns units */
+    unsigned int tid;            /* thread id */
+    unsigned int reserved;
+};
+
+static struct debug_ring_header *debug_rings;
+
+#define NO_DEBUG_RING ((struct debug_ring *)~(ULONG_PTR)0)
+
+static void init_debug_rings(void)
+{
+    const char *prefix = getenv( "WINEDEBUGRING" );
+    size_t size = sizeof(*debug_rings) + DEBUG_RING_SLOTS * sizeof(struct debug_ring);
+    char *name;
+    void *ptr;
+    int fd;
+
+    if (!prefix || !*prefix) return;
+    if (!(name = malloc( strlen(prefix) + 16 ))) return;
+    sprintf( name, "%s.%u", prefix, (unsigned int)getpid() );
+
+    fd = open( name, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+    if (fd == -1 || ftruncate( fd, size ) == -1)
+    {
+        fprintf( stderr, "wine: failed to create debug ring file %s\n", name );
+        if (fd != -1) close( fd );
+        free( name );
+        return;
+    }
+    free( name );
+
+    ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    close( fd );
+    if (ptr == MAP_FAILED) return;
+
+    debug_rings = ptr;
+    debug_rings->version    = 1;
+    debug_rings->slot_count = DEBUG_RING_SLOTS;
+    debug_rings->slot_size  = DEBUG_RING_SIZE;
+    debug_rings->unix_pid   = getpid();
+    debug_rings->magic      = DEBUG_RING_MAGIC;
+}
+
+/* claim a free ring for the current thread */
+static struct debug_ring *get_debug_ring( struct debug_info *info )
+{
+    struct debug_ring *ring = (struct debug_ring *)(debug_rings + 1);
+    int tid = GetCurrentThreadId();
+    unsigned int i;
+
+    if (info->ring) return info->ring;
+
+    if (!debug_rings->pid) debug_rings->pid = GetCurrentProcessId();
+    for (i = 0; i < DEBUG_RING_SLOTS; i++, ring++)
+        if (!interlocked_cmpxchg( &ring->owner, tid, 0 )) return info->ring = ring;
+
+    return info->ring = NO_DEBUG_RING;
+}
+
+/* append a chunk of output to the ring of the current thread, return FALSE if there's none */
+static BOOL write_debug_ring( struct debug_info *info, const char *str, unsigned int len )
+{
+    struct debug_ring *ring = get_debug_ring( info );
+    struct debug_record *record;
+    unsigned int pos, size;
+    LARGE_INTEGER time;
+
+    if (ring == NO_DEBUG_RING) return FALSE;
+
+    size = (sizeof(*record) + len + 7) & ~7;
+    pos = ring->head;
+    if (pos + size > DEBUG_RING_SIZE)
+    {
+        /* don't split records, pad up to the end of the ring instead */
+        if (pos + sizeof(*record) <= DEBUG_RING_SIZE)
+        {
+            record = (struct debug_record *)(ring->data + pos);
+            record->magic = DEBUG_RECORD_MAGIC;
+            record->len   = DEBUG_RECORD_WRAP;
+        }
+        ring->wrapped = 1;
+        pos = 0;
+    }
+
+    NtQueryPerformanceCounter( &time, NULL );
+    record = (struct debug_record *)(ring->data + pos);
+    record->magic    = DEBUG_RECORD_MAGIC;
+    record->len      = len;
+    record->time     = time.QuadPart;
+    record->tid      = GetCurrentThreadId();
+    record->reserved = 0;
+    memcpy( record + 1, str, len );
+
+    /* publish the record only once it's complete */
+    interlocked_xchg( &ring->head, (pos + size) % DEBUG_RING_SIZE );
+    return TRUE;
+}
+
+/***********************************************************************
+ *		debug_exit_thread
+ *
+ * Release the debug ring of an exiting thread, its contents are kept.
+ */
+void debug_exit_thread(void)
+{
+    struct debug_info *info = ntdll_get_thread_data()->debug_info;
+
+    if (info->ring && info->ring != NO_DEBUG_RING) info->ring->owner = 0;
+    info->ring = NULL;
+}
+
+/* output a chunk of complete lines */
+static void write_debug_output( struct debug_info *info, const char *str, unsigned int len )
+{
+    if (debug_rings && len <= DEBUG_RING_SIZE / 4 && write_debug_ring( info, str, len )) return;
+    write( 2, str, len );
+}
+
 /* get the debug info pointer for the current thread */
 static inline struct debug_info *get_info(void)
 {
@@ -144,7 +304,7 @@ static int NTDLL_dbg_vprintf( const char *format, va_list args )
     else
     {
         char *pos = info->output;
-        write( 2, pos, info->out_pos + end - pos );
+        write_debug_output( info, pos, info->out_pos + end - pos );
         /* move beginning of next line to start of buffer */
         memmove( pos, info->out_pos + end, ret - end );
         info->out_pos = pos + ret - end;
@@ -199,5 +359,6 @@ static const struct __wine_debug_functions funcs =
  */
 void debug_init(void)
 {
+    init_debug_rings();
     __wine_dbg_set_functions( &funcs, &default_funcs, sizeof(funcs) );
 }
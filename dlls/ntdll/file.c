@@ -804,6 +804,17 @@ static NTSTATUS register_async_file_read( HANDLE handle, HANDLE event,
 }
 
 
+/* completion notifications to skip for an overlapped I/O that completed synchronously */
+static unsigned int get_sync_completion_flags( HANDLE handle, enum server_fd_type type )
+{
+    unsigned int flags = server_get_fd_completion_mode( handle );
+
+    /* only regular files are read or written on the fast I/O path */
+    if (type != FD_TYPE_FILE) flags &= ~FILE_SKIP_SET_USER_EVENT_ON_FAST_IO;
+    return flags;
+}
+
+
 /******************************************************************************
  *  NtReadFile					[NTDLL.@]
  *  ZwReadFile					[NTDLL.@]
@@ -839,6 +850,7 @@ NTSTATUS WINAPI NtReadFile(HANDLE hFile, HANDLE hEvent,
     enum server_fd_type type;
     ULONG_PTR cvalue = apc ? 0 : (ULONG_PTR)apc_user;
     BOOL send_completion = FALSE, async_read, timeout_init_done = FALSE;
+    unsigned int comp_flags = 0;
 
     TRACE("(%p,%p,%p,%p,%p,%p,0x%08x,%p,%p),partial stub!\n",
           hFile,hEvent,apc,apc_user,io_status,buffer,length,offset,key);
@@ -1001,12 +1013,15 @@ done:
 
 err:
     if (needs_close) close( unix_handle );
+    if (status == STATUS_SUCCESS && async_read)
+        comp_flags = get_sync_completion_flags( hFile, type );
+    if (comp_flags & FILE_SKIP_COMPLETION_PORT_ON_SUCCESS) send_completion = FALSE;
     if (status == STATUS_SUCCESS || (status == STATUS_END_OF_FILE && !async_read))
     {
         io_status->u.Status = status;
         io_status->Information = total;
         TRACE("= SUCCESS (%u)\n", total);
-        if (hEvent) NtSetEvent( hEvent, NULL );
+        if (hEvent && !(comp_flags & FILE_SKIP_SET_USER_EVENT_ON_FAST_IO)) NtSetEvent( hEvent, NULL );
         if (apc && !status) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc,
                                               (ULONG_PTR)apc_user, (ULONG_PTR)io_status, 0 );
     }
@@ -1204,7 +1219,8 @@ NTSTATUS WINAPI NtWriteFile(HANDLE hFile, HANDLE hEvent,
     ULONG total = 0;
     enum server_fd_type type;
     ULONG_PTR cvalue = apc ? 0 : (ULONG_PTR)apc_user;
-    BOOL send_completion = FALSE, async_write, append_write = FALSE, timeout_init_done = FALSE;
+    BOOL send_completion = FALSE, async_write = FALSE, append_write = FALSE, timeout_init_done = FALSE;
+    unsigned int comp_flags = 0;
     LARGE_INTEGER offset_eof;
 
     TRACE("(%p,%p,%p,%p,%p,%p,0x%08x,%p,%p)!\n",
@@ -1395,12 +1411,15 @@ err:
     if (type == FD_TYPE_SERIAL && (status == STATUS_SUCCESS || status == STATUS_PENDING))
         set_pending_write( hFile );
 
+    if (status == STATUS_SUCCESS && async_write)
+        comp_flags = get_sync_completion_flags( hFile, type );
+    if (comp_flags & FILE_SKIP_COMPLETION_PORT_ON_SUCCESS) send_completion = FALSE;
     if (status == STATUS_SUCCESS)
     {
         io_status->u.Status = status;
         io_status->Information = total;
         TRACE("= SUCCESS (%u)\n", total);
-        if (hEvent) NtSetEvent( hEvent, NULL );
+        if (hEvent && !(comp_flags & FILE_SKIP_SET_USER_EVENT_ON_FAST_IO)) NtSetEvent( hEvent, NULL );
         if (apc) NtQueueApcThread( GetCurrentThread(), (PNTAPCFUNC)apc,
                                    (ULONG_PTR)apc_user, (ULONG_PTR)io_status, 0 );
     }
@@ -2738,6 +2757,21 @@ NTSTATUS WINAPI NtSetInformationFile(HANDLE handle, PIO_STATUS_BLOCK io,
             io->u.Status = STATUS_INVALID_PARAMETER_3;
         break;
 
+    case FileIoCompletionNotificationInformation:
+        if (len >= sizeof(FILE_IO_COMPLETION_NOTIFICATION_INFORMATION))
+        {
+            FILE_IO_COMPLETION_NOTIFICATION_INFORMATION *info = ptr;
+
+            if (info->Flags & ~(FILE_SKIP_COMPLETION_PORT_ON_SUCCESS | FILE_SKIP_SET_EVENT_ON_HANDLE |
+                                FILE_SKIP_SET_USER_EVENT_ON_FAST_IO))
+                io->u.Status = STATUS_INVALID_PARAMETER;
+            else
+                io->u.Status = server_set_fd_completion_mode( handle, info->Flags );
+        }
+        else
+            io->u.Status = STATUS_INFO_LENGTH_MISMATCH;
+        break;
+
     case FileAllInformation:
         io->u.Status = STATUS_INVALID_INFO_CLASS;
         break;
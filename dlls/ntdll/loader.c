@@ -82,6 +82,7 @@ static const char * const reason_names[] =
 };
 
 static const WCHAR dllW[] = {'.','d','l','l',0};
+static const WCHAR no_extW[1];
 
 /* internal representation of 32bit modules. per process. */
 typedef struct _wine_modref
@@ -92,6 +93,8 @@ typedef struct _wine_modref
     int                   alloc_deps;
     int                   nDeps;
     struct _wine_modref **deps;
+    struct export_hash   *export_hash;
+    struct _wine_modref  *next_retired;  /* next unloaded module waiting to be freed */
 } WINE_MODREF;
 
 /* info about the current builtin dll load */
@@ -122,8 +125,192 @@ static RTL_CRITICAL_SECTION_DEBUG critsect_debug =
 static RTL_CRITICAL_SECTION loader_section = { &critsect_debug, -1, 0, 0, 0, 0 };
 
 static WINE_MODREF *cached_modref;
+
+/* Sorted array of the address ranges of all loaded modules, used to map an address
+ * to its module without walking the module list. Updates are done under the
+ * loader_section by building a new copy; lookups don't take any lock, so old
+ * copies are only freed once no lookup is in progress. The index also chains
+ * the modules by base name, to find them by name without walking the list. */
+#define MODULE_NAME_HASH_SIZE 64
+
+struct module_range
+{
+    const char  *base;
+    const char  *end;
+    LDR_MODULE  *mod;
+    unsigned int serial;           /* load order of the module */
+    unsigned int next_name;        /* next range in the same name bucket, plus one */
+};
+
+struct module_index
+{
+    struct module_index *next;     /* next retired index */
+    unsigned int         count;
+    unsigned int         names[MODULE_NAME_HASH_SIZE];  /* first range of each name bucket, plus one */
+    struct module_range  ranges[1];
+};
+
+static struct module_index *module_index;
+static struct module_index *retired_module_index;
+static WINE_MODREF *retired_modrefs;  /* unloaded modules that lookups may still be using */
+static LONG module_index_readers;
+static unsigned int module_serial;
+
+static void free_modref_memory( WINE_MODREF *wm );
+
+/* free the retired indexes and modules; the loader_section must be locked and no lookup in progress */
+static void free_retired_module_data(void)
+{
+    struct module_index *old;
+    WINE_MODREF *wm;
+
+    while ((old = retired_module_index))
+    {
+        retired_module_index = old->next;
+        RtlFreeHeap( GetProcessHeap(), 0, old );
+    }
+    while ((wm = retired_modrefs))
+    {
+        retired_modrefs = wm->next_retired;
+        free_modref_memory( wm );
+    }
+}
+
+/* replace the module index; the loader_section must be locked */
+static void set_module_index( struct module_index *index )
+{
+    struct module_index *old = interlocked_xchg_ptr( (void **)&module_index, index );
+
+    if (old)
+    {
+        old->next = retired_module_index;
+        retired_module_index = old;
+    }
+    /* readers starting from now on can only see the new index */
+    if (interlocked_xchg_add( &module_index_readers, 0 )) return;
+    free_retired_module_data();
+}
+
+/* free a module removed from the index once no lookup can be using it anymore;
+ * until then it stays mapped; the loader_section must be locked */
+static void retire_modref( WINE_MODREF *wm )
+{
+    wm->next_retired = retired_modrefs;
+    retired_modrefs = wm;
+    if (interlocked_xchg_add( &module_index_readers, 0 )) return;
+    free_retired_module_data();
+}
+
+/* case-insensitive hash of a module base name followed by an extension */
+static unsigned int hash_module_name( const WCHAR *name, const WCHAR *ext )
+{
+    unsigned int hash = 0;
+
+    while (*name) hash = hash * 31 + toupperW( *name++ );
+    while (*ext) hash = hash * 31 + toupperW( *ext++ );
+    return hash % MODULE_NAME_HASH_SIZE;
+}
+
+/* rebuild the name chains of a new index */
+static void hash_module_names( struct module_index *index )
+{
+    unsigned int i, hash;
+
+    memset( index->names, 0, sizeof(index->names) );
+    for (i = index->count; i > 0; i--)
+    {
+        hash = hash_module_name( index->ranges[i - 1].mod->BaseDllName.Buffer, no_extW );
+        index->ranges[i - 1].next_name = index->names[hash];
+        index->names[hash] = i;
+    }
+}
+
+/* find the first loaded module with the given base name and extension */
+static LDR_MODULE *find_indexed_module( const struct module_index *index, const WCHAR *name, const WCHAR *ext )
+{
+    const struct module_range *range, *found = NULL;
+    unsigned int pos, len = strlenW( name );
+
+    for (pos = index->names[hash_module_name( name, ext )]; pos; pos = range->next_name)
+    {
+        range = &index->ranges[pos - 1];
+        if (range->base == range->end) continue;  /* removed */
+        if (found && found->serial < range->serial) continue;
+        if (strncmpiW( range->mod->BaseDllName.Buffer, name, len )) continue;
+        if (strcmpiW( range->mod->BaseDllName.Buffer + len, ext )) continue;
+        found = range;
+    }
+    return found ? found->mod : NULL;
+}
+
+/* return the position of the first range ending above addr */
+static unsigned int find_module_range( const struct module_index *index, const void *addr )
+{
+    unsigned int min = 0, max = index->count;
+
+    while (min < max)
+    {
+        unsigned int pos = (min + max) / 2;
+        if ((const char *)addr < index->ranges[pos].end) max = pos;
+        else min = pos + 1;
+    }
+    return min;
+}
+
+/* add a module to the index; the loader_section must be locked */
+static void add_module_range( LDR_MODULE *mod )
+{
+    struct module_index *old = module_index, *index;
+    unsigned int count = old ? old->count : 0, pos = 0;
+
+    if (!(index = RtlAllocateHeap( GetProcessHeap(), 0,
+                                   FIELD_OFFSET( struct module_index, ranges[count + 1] ))))
+    {
+        ERR( "out of memory, %s can't be found by address or name\n", debugstr_w(mod->BaseDllName.Buffer) );
+        return;
+    }
+    if (old)
+    {
+        pos = find_module_range( old, mod->BaseAddress );
+        memcpy( index->ranges, old->ranges, pos * sizeof(index->ranges[0]) );
+        memcpy( index->ranges + pos + 1, old->ranges + pos, (count - pos) * sizeof(index->ranges[0]) );
+    }
+    index->count = count + 1;
+    index->ranges[pos].base = mod->BaseAddress;
+    index->ranges[pos].end  = (const char *)mod->BaseAddress + mod->SizeOfImage;
+    index->ranges[pos].mod  = mod;
+    index->ranges[pos].serial = module_serial++;
+    hash_module_names( index );
+    set_module_index( index );
+}
+
+/* remove a module from the index; the loader_section must be locked */
+static void remove_module_range( LDR_MODULE *mod )
+{
+    struct module_index *old = module_index, *index;
+    unsigned int pos;
+
+    if (!old) return;
+    for (pos = find_module_range( old, mod->BaseAddress ); pos < old->count; pos++)
+        if (old->ranges[pos].mod == mod) break;
+    if (pos == old->count) return;
+
+    if (!(index = RtlAllocateHeap( GetProcessHeap(), 0,
+                                   FIELD_OFFSET( struct module_index, ranges[old->count - 1] ))))
+    {
+        /* keep the range but make sure it doesn't match anymore */
+        old->ranges[pos].end = old->ranges[pos].base;
+        return;
+    }
+    index->count = old->count - 1;
+    memcpy( index->ranges, old->ranges, pos * sizeof(index->ranges[0]) );
+    memcpy( index->ranges + pos, old->ranges + pos + 1, (index->count - pos) * sizeof(index->ranges[0]) );
+    hash_module_names( index );
+    set_module_index( index );
+}
 static WINE_MODREF *current_modref;
 static WINE_MODREF *last_failed_modref;
+static int forward_load_depth;  /* number of forwarded export targets being loaded */
 
 static NTSTATUS load_dll( LPCWSTR load_path, LPCWSTR libname, DWORD flags, WINE_MODREF** pwm );
 static NTSTATUS process_attach( WINE_MODREF *wm, LPVOID lpReserved );
@@ -351,19 +538,12 @@ static inline ULONG_PTR allocate_stub( const char *dll, const char *name ) { ret
  */
 static WINE_MODREF *get_modref( HMODULE hmod )
 {
-    PLIST_ENTRY mark, entry;
     PLDR_MODULE mod;
 
     if (cached_modref && cached_modref->ldr.BaseAddress == hmod) return cached_modref;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InMemoryOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
-    {
-        mod = CONTAINING_RECORD(entry, LDR_MODULE, InMemoryOrderModuleList);
-        if (mod->BaseAddress == hmod)
-            return cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
-    }
-    return NULL;
+    if (LdrFindEntryForAddress( hmod, &mod ) || mod->BaseAddress != hmod) return NULL;
+    return cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
 }
 
 
@@ -375,22 +555,13 @@ static WINE_MODREF *get_modref( HMODULE hmod )
  */
 static WINE_MODREF *find_basename_module( LPCWSTR name )
 {
-    PLIST_ENTRY mark, entry;
+    LDR_MODULE *mod;
 
     if (cached_modref && !strcmpiW( name, cached_modref->ldr.BaseDllName.Buffer ))
         return cached_modref;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InLoadOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
-    {
-        LDR_MODULE *mod = CONTAINING_RECORD(entry, LDR_MODULE, InLoadOrderModuleList);
-        if (!strcmpiW( name, mod->BaseDllName.Buffer ))
-        {
-            cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
-            return cached_modref;
-        }
-    }
-    return NULL;
+    if (!module_index || !(mod = find_indexed_module( module_index, name, no_extW ))) return NULL;
+    return cached_modref = CONTAINING_RECORD(mod, WINE_MODREF, ldr);
 }
 
 
@@ -477,9 +648,13 @@ static FARPROC find_forwarded_export( HMODULE module, const char *forward, LPCWS
 
     if (!(wm = find_basename_module( mod_name )))
     {
+        NTSTATUS status;
+
         TRACE( "delay loading %s for '%s'\n", debugstr_w(mod_name), forward );
-        if (load_dll( load_path, mod_name, 0, &wm ) == STATUS_SUCCESS &&
-            !(wm->ldr.Flags & LDR_DONT_RESOLVE_REFS))
+        forward_load_depth++;
+        status = load_dll( load_path, mod_name, 0, &wm );
+        forward_load_depth--;
+        if (status == STATUS_SUCCESS && !(wm->ldr.Flags & LDR_DONT_RESOLVE_REFS))
         {
             if (!imports_fixup_done && current_modref)
             {
@@ -573,13 +748,14 @@ static FARPROC find_ordinal_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY
 
 
 /*************************************************************************
- *		find_named_export
+ *		find_name_ordinal
  *
- * Find an exported function by name.
- * The loader_section must be locked while calling this function.
+ * Find the ordinal of an exported name, or -1 if not found. Only the hint
+ * is checked if search is FALSE.
+ * The exports base is not added to the returned ordinal.
  */
-static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
-                                  DWORD exp_size, const char *name, int hint, LPCWSTR load_path )
+static int find_name_ordinal( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
+                              const char *name, int hint, BOOL search )
 {
     const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
     const DWORD *names = get_rva( module, exports->AddressOfNames );
@@ -589,22 +765,164 @@ static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *
     if (hint >= 0 && hint <= max)
     {
         char *ename = get_rva( module, names[hint] );
-        if (!strcmp( ename, name ))
-            return find_ordinal_export( module, exports, exp_size, ordinals[hint], load_path );
+        if (!strcmp( ename, name )) return ordinals[hint];
     }
+    if (!search) return -1;
 
     /* then do a binary search */
     while (min <= max)
     {
         int res, pos = (min + max) / 2;
         char *ename = get_rva( module, names[pos] );
-        if (!(res = strcmp( ename, name )))
-            return find_ordinal_export( module, exports, exp_size, ordinals[pos], load_path );
+        if (!(res = strcmp( ename, name ))) return ordinals[pos];
         if (res > 0) max = pos - 1;
         else min = pos + 1;
     }
-    return NULL;
+    return -1;
+}
 
+
+/* Hash of the exported names of a module, built the first time a name is looked
+ * up without a matching hint. Resolved forwarded exports are cached in the entries;
+ * they are only valid as long as no module has been unloaded since. */
+struct export_hash_entry
+{
+    DWORD        hash;
+    DWORD        name;         /* position in the names table, plus one; 0 if free */
+    WORD         ordinal;
+    LONG         forward_gen;  /* export_cache_generation of the cached forward */
+    FARPROC      forward;
+};
+
+struct export_hash
+{
+    DWORD                    mask;
+    struct export_hash_entry entries[1];
+};
+
+static LONG export_cache_generation = 1;
+
+static inline DWORD hash_export_name( const char *name )
+{
+    DWORD hash = 2166136261u;
+
+    while (*name) hash = (hash ^ (unsigned char)*name++) * 16777619;
+    return hash;
+}
+
+/* build the export hash of a module; it can be done without the loader_section */
+static struct export_hash *create_export_hash( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports )
+{
+    HMODULE module = wm->ldr.BaseAddress;
+    const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
+    const DWORD *names = get_rva( module, exports->AddressOfNames );
+    struct export_hash *hash;
+    DWORD i, pos, size = 16;
+
+    while (size < 2 * exports->NumberOfNames) size *= 2;
+    if (!(hash = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                  FIELD_OFFSET( struct export_hash, entries[size] ))))
+        return NULL;
+    hash->mask = size - 1;
+    for (i = 0; i < exports->NumberOfNames; i++)
+    {
+        DWORD value = hash_export_name( get_rva( module, names[i] ));
+
+        for (pos = value & hash->mask; hash->entries[pos].name; pos = (pos + 1) & hash->mask) ;
+        hash->entries[pos].hash    = value;
+        hash->entries[pos].name    = i + 1;
+        hash->entries[pos].ordinal = ordinals[i];
+    }
+    if (interlocked_cmpxchg_ptr( (void **)&wm->export_hash, hash, NULL ))
+    {
+        /* another thread was faster */
+        RtlFreeHeap( GetProcessHeap(), 0, hash );
+    }
+    return wm->export_hash;
+}
+
+/* look up an exported name in the export hash of a module;
+ * returns FALSE if the hash isn't available and the names table needs to be searched */
+static BOOL find_export_hash_entry( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports,
+                                    const char *name, struct export_hash_entry **ret )
+{
+    HMODULE module = wm->ldr.BaseAddress;
+    const DWORD *names = get_rva( module, exports->AddressOfNames );
+    struct export_hash *hash = wm->export_hash;
+    DWORD pos, value;
+
+    *ret = NULL;
+    if (!hash && !(hash = create_export_hash( wm, exports ))) return FALSE;
+
+    value = hash_export_name( name );
+    for (pos = value & hash->mask; hash->entries[pos].name; pos = (pos + 1) & hash->mask)
+    {
+        struct export_hash_entry *entry = &hash->entries[pos];
+        if (entry->hash != value) continue;
+        if (strcmp( get_rva( module, names[entry->name - 1] ), name )) continue;
+        *ret = entry;
+        break;
+    }
+    return TRUE;
+}
+
+/* return the cached forward of an export hash entry, if still valid */
+static inline FARPROC get_cached_forward( struct export_hash_entry *entry )
+{
+    /* the interlocked read orders the load of the forward after the generation check,
+     * it pairs with the interlocked_xchg publishing the generation in find_named_export */
+    if (interlocked_cmpxchg( &entry->forward_gen, 0, 0 ) != *(volatile LONG *)&export_cache_generation)
+        return NULL;
+    return *(FARPROC volatile *)&entry->forward;
+}
+
+/* check whether an exported ordinal is a forward */
+static inline BOOL is_forwarded_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
+                                        DWORD exp_size, DWORD ordinal )
+{
+    const DWORD *functions = get_rva( module, exports->AddressOfFunctions );
+    DWORD dir = (const char *)exports - (const char *)module;
+
+    if (ordinal >= exports->NumberOfFunctions) return FALSE;
+    return functions[ordinal] >= dir && functions[ordinal] < dir + exp_size;
+}
+
+
+/*************************************************************************
+ *		find_named_export
+ *
+ * Find an exported function by name.
+ * The loader_section must be locked while calling this function.
+ */
+static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports,
+                                  DWORD exp_size, const char *name, int hint, LPCWSTR load_path )
+{
+    struct export_hash_entry *entry = NULL;
+    WINE_MODREF *wm;
+    FARPROC proc;
+    int ordinal;
+
+    /* the hint is checked first, so hash only when it doesn't match */
+    ordinal = find_name_ordinal( module, exports, name, hint, FALSE );
+    if (ordinal == -1 && exports->NumberOfNames && (wm = get_modref( module )) &&
+        find_export_hash_entry( wm, exports, name, &entry ))
+    {
+        if (!entry) return NULL;
+        ordinal = entry->ordinal;
+        if (!TRACE_ON(relay) && !TRACE_ON(snoop) && (proc = get_cached_forward( entry ))) return proc;
+    }
+    else if (ordinal == -1) ordinal = find_name_ordinal( module, exports, name, hint, TRUE );
+
+    if (ordinal == -1) return NULL;
+    proc = find_ordinal_export( module, exports, exp_size, ordinal, load_path );
+
+    if (proc && entry && !TRACE_ON(relay) && !TRACE_ON(snoop) &&
+        is_forwarded_export( module, exports, exp_size, ordinal ))
+    {
+        entry->forward = proc;
+        interlocked_xchg( &entry->forward_gen, export_cache_generation );
+    }
+    return proc;
 }
 
 
@@ -1062,6 +1380,7 @@ static WINE_MODREF *alloc_module( HMODULE hModule, LPCWSTR filename )
                    &wm->ldr.InLoadOrderModuleList);
     InsertTailList(&NtCurrentTeb()->Peb->LdrData->InMemoryOrderModuleList,
                    &wm->ldr.InMemoryOrderModuleList);
+    add_module_range( &wm->ldr );
     /* wait until init is called for inserting into InInitializationOrderModuleList */
 
     if (!(nt->OptionalHeader.DllCharacteristics & IMAGE_DLLCHARACTERISTICS_NX_COMPAT))
@@ -1412,25 +1731,27 @@ NTSTATUS WINAPI LdrDisableThreadCalloutsForDll(HMODULE hModule)
 /******************************************************************
  *              LdrFindEntryForAddress (NTDLL.@)
  *
- * The loader_section must be locked while calling this function
+ * The lookup itself doesn't need the loader_section, but it must be locked
+ * to ensure that the returned module doesn't get unloaded.
  */
 NTSTATUS WINAPI LdrFindEntryForAddress(const void* addr, PLDR_MODULE* pmod)
 {
-    PLIST_ENTRY mark, entry;
-    PLDR_MODULE mod;
+    const struct module_index *index;
+    NTSTATUS status = STATUS_NO_MORE_ENTRIES;
+    unsigned int pos;
 
-    mark = &NtCurrentTeb()->Peb->LdrData->InMemoryOrderModuleList;
-    for (entry = mark->Flink; entry != mark; entry = entry->Flink)
+    interlocked_xchg_add( &module_index_readers, 1 );
+    if ((index = *(struct module_index * volatile *)&module_index))
     {
-        mod = CONTAINING_RECORD(entry, LDR_MODULE, InMemoryOrderModuleList);
-        if (mod->BaseAddress <= addr &&
-            (const char *)addr < (char*)mod->BaseAddress + mod->SizeOfImage)
+        pos = find_module_range( index, addr );
+        if (pos < index->count && index->ranges[pos].base <= (const char *)addr)
         {
-            *pmod = mod;
-            return STATUS_SUCCESS;
+            *pmod = index->ranges[pos].mod;
+            status = STATUS_SUCCESS;
         }
     }
-    return STATUS_NO_MORE_ENTRIES;
+    interlocked_xchg_add( &module_index_readers, -1 );
+    return status;
 }
 
 /******************************************************************
@@ -1510,6 +1831,72 @@ NTSTATUS WINAPI LdrUnlockLoaderLock( ULONG flags, ULONG_PTR magic )
 }
 
 
+/*************************************************************************
+ *		find_export_unlocked
+ *
+ * Look up an export of an initialized module without locking the loader_section.
+ * Returns FALSE if the lookup needs the loader_section, for instance for forwarded
+ * exports that haven't been resolved yet or when relay or snoop tracing is enabled.
+ */
+static BOOL find_export_unlocked( HMODULE module, const ANSI_STRING *name, ULONG ord,
+                                  void **address, NTSTATUS *status )
+{
+    const struct module_index *index;
+    const IMAGE_EXPORT_DIRECTORY *exports;
+    struct export_hash_entry *entry;
+    const DWORD *functions;
+    WINE_MODREF *wm;
+    const char *proc;
+    DWORD exp_size;
+    unsigned int pos;
+    int ordinal;
+    BOOL ret = FALSE;
+
+    if (TRACE_ON(snoop) || TRACE_ON(relay)) return FALSE;
+
+    interlocked_xchg_add( &module_index_readers, 1 );
+    if (!(index = *(struct module_index * volatile *)&module_index)) goto done;
+    pos = find_module_range( index, module );
+    if (pos == index->count || index->ranges[pos].base != (const char *)module) goto done;
+    if (!(index->ranges[pos].mod->Flags & LDR_PROCESS_ATTACHED)) goto done;
+    wm = CONTAINING_RECORD( index->ranges[pos].mod, WINE_MODREF, ldr );
+
+    ret = TRUE;
+    *status = STATUS_PROCEDURE_NOT_FOUND;
+    if (!(exports = RtlImageDirectoryEntryToData( module, TRUE, IMAGE_DIRECTORY_ENTRY_EXPORT, &exp_size )))
+        goto done;
+    if (!name) ordinal = ord - exports->Base;
+    else if (!exports->NumberOfNames) goto done;
+    else if (find_export_hash_entry( wm, exports, name->Buffer, &entry ))
+    {
+        if (!entry) goto done;
+        ordinal = entry->ordinal;
+        if ((proc = (const char *)get_cached_forward( entry )))
+        {
+            *address = (void *)proc;
+            *status = STATUS_SUCCESS;
+            goto done;
+        }
+    }
+    else if ((ordinal = find_name_ordinal( module, exports, name->Buffer, -1, TRUE )) == -1) goto done;
+
+    /* let the full lookup deal with the other cases */
+    ret = FALSE;
+    if ((DWORD)ordinal >= exports->NumberOfFunctions) goto done;
+    functions = get_rva( module, exports->AddressOfFunctions );
+    if (!functions[ordinal]) goto done;
+    proc = get_rva( module, functions[ordinal] );
+    if (proc >= (const char *)exports && proc < (const char *)exports + exp_size) goto done;
+
+    *address = (void *)proc;
+    *status = STATUS_SUCCESS;
+    ret = TRUE;
+done:
+    interlocked_xchg_add( &module_index_readers, -1 );
+    return ret;
+}
+
+
 /******************************************************************
  *		LdrGetProcedureAddress  (NTDLL.@)
  */
@@ -1520,6 +1907,8 @@ NTSTATUS WINAPI LdrGetProcedureAddress(HMODULE module, const ANSI_STRING *name,
     DWORD exp_size;
     NTSTATUS ret = STATUS_PROCEDURE_NOT_FOUND;
 
+    if (find_export_unlocked( module, name, ord, address, &ret )) return ret;
+
     RtlEnterCriticalSection( &loader_section );
 
     /* check if the module itself is invalid to return the proper error */
@@ -1681,6 +2070,7 @@ static void load_builtin_callback( void *module, const char *filename )
             /* the module has only be inserted in the load & memory order lists */
             RemoveEntryList(&wm->ldr.InLoadOrderModuleList);
             RemoveEntryList(&wm->ldr.InMemoryOrderModuleList);
+            remove_module_range( &wm->ldr );
             /* FIXME: free the modref */
             builtin_load_info->status = STATUS_DLL_NOT_FOUND;
             return;
@@ -1756,7 +2146,70 @@ static void set_security_cookie( void *module, SIZE_T len )
     }
 }
 
-static NTSTATUS perform_relocations( void *module, SIZE_T len )
+/*************************************************************************
+ *		share_relocated_image
+ *
+ * Give a copy of a freshly relocated image to the server, so that other
+ * processes that can't load it at its preferred base either can map it at
+ * the same address without relocating it again, and share its pages.
+ */
+static void share_relocated_image( HANDLE mapping, void *module, SIZE_T len )
+{
+    IMAGE_NT_HEADERS *nt = RtlImageNtHeader( module );
+    ULONG_PTR image_base = (ULONG_PTR)module;
+    client_ptr_t relocated_base = 0;
+    HANDLE section;
+    LARGE_INTEGER size;
+    NTSTATUS status;
+    SIZE_T pos;
+    int fd, needs_close;
+    ssize_t ret;
+
+    if (nt->OptionalHeader.Magic != IMAGE_NT_OPTIONAL_HDR_MAGIC) return;
+
+    SERVER_START_REQ( get_mapping_info )
+    {
+        req->handle = wine_server_obj_handle( mapping );
+        req->access = 0;
+        status = wine_server_call( req );
+        relocated_base = reply->relocated_base;
+    }
+    SERVER_END_REQ;
+    if (status || relocated_base) return;
+
+    size.QuadPart = len;
+    if (NtCreateSection( &section, STANDARD_RIGHTS_REQUIRED | SECTION_QUERY | SECTION_MAP_READ |
+                         SECTION_MAP_WRITE, NULL, &size, PAGE_READWRITE, SEC_COMMIT, 0 )) return;
+    if (server_get_unix_fd( section, 0, &fd, &needs_close, NULL, NULL ))
+    {
+        NtClose( section );
+        return;
+    }
+
+    /* pages that can't be read make write() fail, the copy is then simply not shared */
+    for (pos = 0; pos < len; pos += ret)
+    {
+        ret = pwrite( fd, (char *)module + pos, len - pos, pos );
+        if (ret <= 0) break;
+    }
+    /* the copy doesn't need relocating anymore */
+    if (pos == len && pwrite( fd, &image_base, sizeof(image_base),
+                              (char *)&nt->OptionalHeader.ImageBase - (char *)module ) == sizeof(image_base))
+    {
+        SERVER_START_REQ( set_relocated_image )
+        {
+            req->mapping = wine_server_obj_handle( section );
+            req->base    = wine_server_client_ptr( module );
+            status = wine_server_call( req );
+        }
+        SERVER_END_REQ;
+        TRACE( "shared relocated copy of %p-%p, status %x\n", module, (char *)module + len, status );
+    }
+    if (needs_close) close( fd );
+    NtClose( section );
+}
+
+static NTSTATUS perform_relocations( HANDLE mapping, void *module, SIZE_T len )
 {
     IMAGE_NT_HEADERS *nt;
     char *base;
@@ -1769,7 +2222,8 @@ static NTSTATUS perform_relocations( void *module, SIZE_T len )
     nt = RtlImageNtHeader( module );
     base = (char *)nt->OptionalHeader.ImageBase;
 
-    assert( module != base );
+    /* mapped from a copy that was already relocated by another process */
+    if (module == base) return STATUS_SUCCESS;
 
     /* no relocations are performed on non page-aligned binaries */
     if (nt->OptionalHeader.SectionAlignment < page_size)
@@ -1823,6 +2277,8 @@ static NTSTATUS perform_relocations( void *module, SIZE_T len )
         if (!rel) return STATUS_INVALID_IMAGE_FORMAT;
     }
 
+    share_relocated_image( mapping, module, len );
+
     for (i = 0; i < nt->FileHeader.NumberOfSections; i++)
     {
         void *addr = get_rva( module, sec[i].VirtualAddress );
@@ -1878,30 +2334,61 @@ static NTSTATUS load_native_dll( LPCWSTR load_path, LPCWSTR name, HANDLE file,
     WINE_MODREF *wm;
     NTSTATUS status;
     pe_image_info_t image_info;
+    BOOL unlocked;
 
     TRACE("Trying native dll %s\n", debugstr_w(name));
 
+    /* mapping and relocating the image doesn't need the loader_section, so let other
+     * threads load their own dlls meanwhile; this is only safe for a load requested
+     * directly by LdrLoadDll, where no partially loaded module can be seen by them.
+     * Imports and forwards are loaded with current_modref set or forward_load_depth
+     * non-zero, and the module that needs them isn't fully resolved yet. */
+    unlocked = imports_fixup_done && !process_detaching && !current_modref && !forward_load_depth &&
+               loader_section.RecursionCount == 1;
+    if (unlocked) RtlLeaveCriticalSection( &loader_section );
+
     size.QuadPart = 0;
     status = NtCreateSection( &mapping, STANDARD_RIGHTS_REQUIRED | SECTION_QUERY |
                               SECTION_MAP_READ | SECTION_MAP_EXECUTE,
                               NULL, &size, PAGE_EXECUTE_READ, SEC_IMAGE, file );
-    if (status != STATUS_SUCCESS) return status;
+    if (status != STATUS_SUCCESS)
+    {
+        if (unlocked) RtlEnterCriticalSection( &loader_section );
+        return status;
+    }
 
     module = NULL;
     status = virtual_map_section( mapping, &module, 0, 0, NULL, &len, PAGE_EXECUTE_READ, &image_info );
-    NtClose( mapping );
 
     if ((status == STATUS_SUCCESS || status == STATUS_IMAGE_NOT_AT_BASE) &&
         !is_valid_binary( module, &image_info ))
     {
+        NtClose( mapping );
         NtUnmapViewOfSection( NtCurrentProcess(), module );
+        if (unlocked) RtlEnterCriticalSection( &loader_section );
         return STATUS_INVALID_IMAGE_FORMAT;
     }
 
     /* perform base relocation, if necessary */
 
     if (status == STATUS_IMAGE_NOT_AT_BASE)
-        status = perform_relocations( module, len );
+        status = perform_relocations( mapping, module, len );
+    NtClose( mapping );
+
+    if (unlocked)
+    {
+        RtlEnterCriticalSection( &loader_section );
+        /* another thread may have loaded the same file in the meantime */
+        if (status == STATUS_SUCCESS && (wm = find_fileid_module( file, st )))
+        {
+            TRACE( "%s has been loaded by another thread at %p\n",
+                   debugstr_w(name), wm->ldr.BaseAddress );
+            NtUnmapViewOfSection( NtCurrentProcess(), module );
+            if (wm->ldr.LoadCount != -1) wm->ldr.LoadCount++;
+            *pwm = wm;
+            return STATUS_SUCCESS;
+        }
+    }
 
     if (status != STATUS_SUCCESS)
     {
@@ -1941,6 +2428,7 @@ static NTSTATUS load_native_dll( LPCWSTR load_path, LPCWSTR name, HANDLE file,
             /* the module has only be inserted in the load & memory order lists */
             RemoveEntryList(&wm->ldr.InLoadOrderModuleList);
             RemoveEntryList(&wm->ldr.InMemoryOrderModuleList);
+            remove_module_range( &wm->ldr );
 
             /* FIXME: there are several more dangling references
              * left. Including dlls loaded by this dll before the
@@ -2486,6 +2974,35 @@ NTSTATUS WINAPI DECLSPEC_HOTPATCH LdrLoadDll(LPCWSTR path_name, DWORD flags,
 }
 
 
+/******************************************************************
+ *		find_dll_handle_unlocked
+ *
+ * Find an initialized module from its base name without locking the loader_section.
+ */
+static BOOL find_dll_handle_unlocked( LPCWSTR name, HMODULE *base )
+{
+    const struct module_index *index;
+    const WCHAR *ext;
+    LDR_MODULE *mod;
+    BOOL ret = FALSE;
+
+    if (contains_path( name )) return FALSE;
+    /* same rule as find_dll_file for appending .dll */
+    if (!(ext = strrchrW( name, '.' ))) ext = dllW;
+    else ext = no_extW;
+
+    interlocked_xchg_add( &module_index_readers, 1 );
+    if ((index = *(struct module_index * volatile *)&module_index) &&
+        (mod = find_indexed_module( index, name, ext )) && (mod->Flags & LDR_PROCESS_ATTACHED))
+    {
+        *base = mod->BaseAddress;
+        ret = TRUE;
+    }
+    interlocked_xchg_add( &module_index_readers, -1 );
+    return ret;
+}
+
+
 /******************************************************************
  *		LdrGetDllHandle (NTDLL.@)
  */
@@ -2499,6 +3016,12 @@ NTSTATUS WINAPI LdrGetDllHandle( LPCWSTR load_path, ULONG flags, const UNICODE_S
     HANDLE handle;
     struct stat st;
 
+    if (find_dll_handle_unlocked( name->Buffer, base ))
+    {
+        TRACE( "%s -> %p\n", debugstr_us(name), *base );
+        return STATUS_SUCCESS;
+    }
+
     RtlEnterCriticalSection( &loader_section );
 
     if (!load_path) load_path = NtCurrentTeb()->Peb->ProcessParameters->DllPath.Buffer;
@@ -2943,6 +3466,7 @@ static void free_modref( WINE_MODREF *wm )
 {
     RemoveEntryList(&wm->ldr.InLoadOrderModuleList);
     RemoveEntryList(&wm->ldr.InMemoryOrderModuleList);
+    remove_module_range( &wm->ldr );
     if (wm->ldr.InInitializationOrderModuleList.Flink)
         RemoveEntryList(&wm->ldr.InInitializationOrderModuleList);
 
@@ -2961,11 +3485,24 @@ static void free_modref( WINE_MODREF *wm )
 
     free_tls_slot( &wm->ldr );
     RtlReleaseActivationContext( wm->ldr.ActivationContext );
+    if (cached_modref == wm) cached_modref = NULL;
+    interlocked_xchg_add( &export_cache_generation, 1 );
+    /* lock-free lookups may still be using the module */
+    retire_modref( wm );
+}
+
+/***********************************************************************
+ *           free_modref_memory
+ *
+ * Unmap and free an unloaded module once no lock-free lookup can see it.
+ */
+static void free_modref_memory( WINE_MODREF *wm )
+{
     if (wm->ldr.Flags & LDR_WINE_INTERNAL) wine_dll_unload( wm->ldr.SectionHandle );
     NtUnmapViewOfSection( NtCurrentProcess(), wm->ldr.BaseAddress );
-    if (cached_modref == wm) cached_modref = NULL;
     RtlFreeUnicodeString( &wm->ldr.FullDllName );
     RtlFreeHeap( GetProcessHeap(), 0, wm->deps );
+    RtlFreeHeap( GetProcessHeap(), 0, wm->export_hash );
     RtlFreeHeap( GetProcessHeap(), 0, wm );
 }
 
@@ -817,7 +817,8 @@ union fd_cache_entry
         int fd;
         enum server_fd_type type : 5;
         unsigned int        access : 3;
-        unsigned int        options : 24;
+        unsigned int        options : 21;    /* only the low options are used by the client */
+        unsigned int        comp_flags : 3;  /* FILE_SKIP_* completion notification flags */
     } s;
 };
 
@@ -843,7 +844,7 @@ static inline unsigned int handle_to_index( HANDLE handle, unsigned int *entry )
  * Caller must hold fd_cache_section.
  */
 static BOOL add_fd_to_cache( HANDLE handle, int fd, enum server_fd_type type,
-                            unsigned int access, unsigned int options )
+                            unsigned int access, unsigned int options, unsigned int comp_flags )
 {
     unsigned int entry, idx = handle_to_index( handle, &entry );
     union fd_cache_entry cache;
@@ -871,6 +872,7 @@ static BOOL add_fd_to_cache( HANDLE handle, int fd, enum server_fd_type type,
     cache.s.type = type;
     cache.s.access = access;
     cache.s.options = options;
+    cache.s.comp_flags = comp_flags;
     cache.data = interlocked_xchg64( &fd_cache[entry][idx].data, cache.data );
     assert( !cache.s.fd );
     return TRUE;
@@ -921,6 +923,61 @@ int server_remove_fd_from_cache( HANDLE handle )
 }
 
 
+/***********************************************************************
+ *           server_get_fd_completion_mode
+ *
+ * Return the completion notification flags of a file whose fd is cached,
+ * without a server round trip. Uncached files report no flags.
+ */
+unsigned int server_get_fd_completion_mode( HANDLE handle )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union fd_cache_entry cache;
+
+    if (entry >= FD_CACHE_ENTRIES || !fd_cache[entry]) return 0;
+
+    cache.data = interlocked_cmpxchg64( &fd_cache[entry][idx].data, 0, 0 );
+    if (!cache.data || cache.s.type == FD_TYPE_INVALID) return 0;
+    return cache.s.comp_flags;
+}
+
+
+/***********************************************************************
+ *           server_set_fd_completion_mode
+ *
+ * Set the completion notification flags of a file and update the fd cache.
+ */
+NTSTATUS server_set_fd_completion_mode( HANDLE handle, unsigned int flags )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union fd_cache_entry cache, new_cache;
+    sigset_t sigset;
+    NTSTATUS status;
+
+    server_enter_uninterrupted_section( &fd_cache_section, &sigset );
+    SERVER_START_REQ( set_fd_completion_mode )
+    {
+        req->handle = wine_server_obj_handle( handle );
+        req->flags  = flags;
+        status = wine_server_call( req );
+    }
+    SERVER_END_REQ;
+
+    if (!status && entry < FD_CACHE_ENTRIES && fd_cache[entry])
+    {
+        do
+        {
+            cache.data = interlocked_cmpxchg64( &fd_cache[entry][idx].data, 0, 0 );
+            if (!cache.data || cache.s.type == FD_TYPE_INVALID) break;
+            new_cache = cache;
+            new_cache.s.comp_flags |= flags;
+        } while (interlocked_cmpxchg64( &fd_cache[entry][idx].data, new_cache.data, cache.data ) != cache.data);
+    }
+    server_leave_uninterrupted_section( &fd_cache_section, &sigset );
+    return status;
+}
+
+
 /***********************************************************************
  *           server_get_unix_fd
  *
@@ -957,14 +1014,14 @@ int server_get_unix_fd( HANDLE handle, unsigned int wanted_access, int *unix_fd,
                 {
                     assert( wine_server_ptr_handle(fd_handle) == handle );
                     *needs_close = (!reply->cacheable ||
-                                    !add_fd_to_cache( handle, fd, reply->type,
-                                                      reply->access, reply->options ));
+                                    !add_fd_to_cache( handle, fd, reply->type, reply->access,
+                                                      reply->options, reply->comp_flags ));
                 }
                 else ret = STATUS_TOO_MANY_OPENED_FILES;
             }
             else if (reply->cacheable)
             {
-                add_fd_to_cache( handle, ret, FD_TYPE_INVALID, 0, 0 );
+                add_fd_to_cache( handle, ret, FD_TYPE_INVALID, 0, 0, 0 );
             }
         }
         SERVER_END_REQ;
@@ -334,12 +334,16 @@ static inline struct amd64_thread_data *amd64_thread_data(void)
 
 struct dynamic_unwind_entry
 {
-    struct list entry;
-
     /* memory region which matches this entry */
     DWORD64 base;
     DWORD size;
 
+    /* highest end address of this entry and all entries before it in the array */
+    DWORD64 max_end;
+
+    /* registration order, the first registered entry wins for overlapping ranges */
+    unsigned int serial;
+
     /* lookup table */
     RUNTIME_FUNCTION *table;
     DWORD table_size;
@@ -349,7 +353,12 @@ struct dynamic_unwind_entry
     PVOID context;
 };
 
-static struct list dynamic_unwind_list = LIST_INIT(dynamic_unwind_list);
+/* sorted by base address; ranges may overlap, max_end allows to find all entries
+ * containing an address with a binary search followed by a short backwards scan */
+static struct dynamic_unwind_entry **dynamic_unwind_entries;
+static unsigned int dynamic_unwind_count;
+static unsigned int dynamic_unwind_size;
+static unsigned int dynamic_unwind_serial;
 
 static RTL_CRITICAL_SECTION dynamic_unwind_section;
 static RTL_CRITICAL_SECTION_DEBUG dynamic_unwind_debug =
@@ -360,6 +369,66 @@ static RTL_CRITICAL_SECTION_DEBUG dynamic_unwind_debug =
 };
 static RTL_CRITICAL_SECTION dynamic_unwind_section = { &dynamic_unwind_debug, -1, 0, 0, 0, 0 };
 
+/* recompute max_end starting at the given position; dynamic_unwind_section must be held */
+static void update_dynamic_unwind_max_end( unsigned int pos )
+{
+    DWORD64 max_end = pos ? dynamic_unwind_entries[pos - 1]->max_end : 0;
+
+    for ( ; pos < dynamic_unwind_count; pos++)
+    {
+        struct dynamic_unwind_entry *entry = dynamic_unwind_entries[pos];
+        if (entry->base + entry->size > max_end) max_end = entry->base + entry->size;
+        entry->max_end = max_end;
+    }
+}
+
+/* return the position of the first entry starting above addr; dynamic_unwind_section must be held */
+static unsigned int find_dynamic_unwind_pos( DWORD64 addr )
+{
+    unsigned int min = 0, max = dynamic_unwind_count;
+
+    while (min < max)
+    {
+        unsigned int pos = (min + max) / 2;
+        if (addr < dynamic_unwind_entries[pos]->base) max = pos;
+        else min = pos + 1;
+    }
+    return min;
+}
+
+static BOOL add_dynamic_unwind_entry( struct dynamic_unwind_entry *entry )
+{
+    unsigned int pos;
+    BOOL ret = FALSE;
+
+    RtlEnterCriticalSection( &dynamic_unwind_section );
+    if (dynamic_unwind_count == dynamic_unwind_size)
+    {
+        unsigned int new_size = max( 16, dynamic_unwind_size * 2 );
+        struct dynamic_unwind_entry **new_entries;
+
+        if (dynamic_unwind_entries)
+            new_entries = RtlReAllocateHeap( GetProcessHeap(), 0, dynamic_unwind_entries,
+                                             new_size * sizeof(*new_entries) );
+        else
+            new_entries = RtlAllocateHeap( GetProcessHeap(), 0, new_size * sizeof(*new_entries) );
+        if (!new_entries) goto done;
+        dynamic_unwind_entries = new_entries;
+        dynamic_unwind_size = new_size;
+    }
+    pos = find_dynamic_unwind_pos( entry->base );
+    memmove( dynamic_unwind_entries + pos + 1, dynamic_unwind_entries + pos,
+             (dynamic_unwind_count - pos) * sizeof(*dynamic_unwind_entries) );
+    dynamic_unwind_entries[pos] = entry;
+    dynamic_unwind_count++;
+    entry->serial = dynamic_unwind_serial++;
+    update_dynamic_unwind_max_end( pos );
+    ret = TRUE;
+done:
+    RtlLeaveCriticalSection( &dynamic_unwind_section );
+    return ret;
+}
+
 /***********************************************************************
  * Definitions for Win32 unwind tables
  */
@@ -2536,7 +2605,8 @@ static RUNTIME_FUNCTION *find_function_info( ULONG64 pc, HMODULE module,
 static RUNTIME_FUNCTION *lookup_function_info( ULONG64 pc, ULONG64 *base, LDR_MODULE **module )
 {
     RUNTIME_FUNCTION *func = NULL;
-    struct dynamic_unwind_entry *entry;
+    struct dynamic_unwind_entry *entry, *found = NULL;
+    unsigned int pos;
     ULONG size;
 
     /* PE module or wine module */
@@ -2555,19 +2625,22 @@ static RUNTIME_FUNCTION *lookup_function_info( ULONG64 pc, ULONG64 *base, LDR_MO
         *module = NULL;
 
         RtlEnterCriticalSection( &dynamic_unwind_section );
-        LIST_FOR_EACH_ENTRY( entry, &dynamic_unwind_list, struct dynamic_unwind_entry, entry )
+        for (pos = find_dynamic_unwind_pos( pc ); pos > 0; pos--)
         {
-            if (pc >= entry->base && pc < entry->base + entry->size)
-            {
-                *base = entry->base;
+            entry = dynamic_unwind_entries[pos - 1];
+            if (pc >= entry->max_end) break;
+            if (pc < entry->base + entry->size && (!found || entry->serial < found->serial))
+                found = entry;
+        }
+        if (found)
+        {
+            *base = found->base;
 
-                /* use callback or lookup in function table */
-                if (entry->callback)
-                    func = entry->callback( pc, entry->context );
-                else
-                    func = find_function_info( pc, (HMODULE)entry->base, entry->table, entry->table_size );
-                break;
-            }
+            /* use callback or lookup in function table */
+            if (found->callback)
+                func = found->callback( pc, found->context );
+            else
+                func = find_function_info( pc, (HMODULE)found->base, found->table, found->table_size );
         }
         RtlLeaveCriticalSection( &dynamic_unwind_section );
     }
@@ -3459,10 +3532,11 @@ BOOLEAN CDECL RtlAddFunctionTable( RUNTIME_FUNCTION *table, DWORD count, DWORD64
     entry->callback   = NULL;
     entry->context    = NULL;
 
-    RtlEnterCriticalSection( &dynamic_unwind_section );
-    list_add_tail( &dynamic_unwind_list, &entry->entry );
-    RtlLeaveCriticalSection( &dynamic_unwind_section );
-
+    if (!add_dynamic_unwind_entry( entry ))
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, entry );
+        return FALSE;
+    }
     return TRUE;
 }
 
@@ -3494,10 +3568,11 @@ BOOLEAN CDECL RtlInstallFunctionTableCallback( DWORD64 table, DWORD64 base, DWOR
     entry->callback   = callback;
     entry->context    = context;
 
-    RtlEnterCriticalSection( &dynamic_unwind_section );
-    list_add_tail( &dynamic_unwind_list, &entry->entry );
-    RtlLeaveCriticalSection( &dynamic_unwind_section );
-
+    if (!add_dynamic_unwind_entry( entry ))
+    {
+        RtlFreeHeap( GetProcessHeap(), 0, entry );
+        return FALSE;
+    }
     return TRUE;
 }
 
@@ -3507,17 +3582,21 @@ BOOLEAN CDECL RtlInstallFunctionTableCallback( DWORD64 table, DWORD64 base, DWOR
  */
 BOOLEAN CDECL RtlDeleteFunctionTable( RUNTIME_FUNCTION *table )
 {
-    struct dynamic_unwind_entry *entry, *to_free = NULL;
+    struct dynamic_unwind_entry *to_free = NULL;
+    unsigned int pos;
 
     TRACE( "%p\n", table );
 
     RtlEnterCriticalSection( &dynamic_unwind_section );
-    LIST_FOR_EACH_ENTRY( entry, &dynamic_unwind_list, struct dynamic_unwind_entry, entry )
+    for (pos = 0; pos < dynamic_unwind_count; pos++)
     {
-        if (entry->table == table)
+        if (dynamic_unwind_entries[pos]->table == table)
         {
-            to_free = entry;
-            list_remove( &entry->entry );
+            to_free = dynamic_unwind_entries[pos];
+            memmove( dynamic_unwind_entries + pos, dynamic_unwind_entries + pos + 1,
+                     (dynamic_unwind_count - pos - 1) * sizeof(*dynamic_unwind_entries) );
+            dynamic_unwind_count--;
+            update_dynamic_unwind_max_end( pos );
             break;
         }
     }
@@ -1386,6 +1386,60 @@ NTSTATUS WINAPI NtRemoveIoCompletion( HANDLE CompletionPort, PULONG_PTR Completi
     return status;
 }
 
+/******************************************************************
+ *              NtRemoveIoCompletionEx (NTDLL.@)
+ *              ZwRemoveIoCompletionEx (NTDLL.@)
+ *
+ * (Wait for and) retrieve up to count completion messages at once
+ *
+ * PARAMS
+ *      port      [I] HANDLE to I/O completion object
+ *      info      [O] array of retrieved completion messages
+ *      count     [I] number of entries in info
+ *      written   [O] number of retrieved messages
+ *      timeout   [I] optional wait time in NTDLL format
+ *      alertable [I] whether the wait is alertable
+ *
+ */
+NTSTATUS WINAPI NtRemoveIoCompletionEx( HANDLE port, FILE_IO_COMPLETION_INFORMATION *info, ULONG count,
+                                        ULONG *written, LARGE_INTEGER *timeout, BOOLEAN alertable )
+{
+    struct completion_info msgs[64];
+    NTSTATUS status;
+    ULONG i, got;
+
+    TRACE("(%p, %p, %u, %p, %p, %u)\n", port, info, count, written, timeout, alertable);
+
+    if (!count) return STATUS_INVALID_PARAMETER;
+
+    for (;;)
+    {
+        SERVER_START_REQ( remove_completions )
+        {
+            req->handle = wine_server_obj_handle( port );
+            wine_server_set_reply( req, msgs, min( count, sizeof(msgs)/sizeof(msgs[0]) ) * sizeof(msgs[0]) );
+            if (!(status = wine_server_call( req )))
+            {
+                got = wine_server_reply_size( reply ) / sizeof(msgs[0]);
+                for (i = 0; i < got; i++)
+                {
+                    info[i].CompletionKey             = msgs[i].ckey;
+                    info[i].CompletionValue           = msgs[i].cvalue;
+                    info[i].IoStatusBlock.Information = msgs[i].information;
+                    info[i].IoStatusBlock.u.Status    = msgs[i].status;
+                }
+                *written = got;
+            }
+        }
+        SERVER_END_REQ;
+        if (status != STATUS_PENDING) break;
+
+        status = NtWaitForSingleObject( port, alertable, timeout );
+        if (status != WAIT_OBJECT_0) break;
+    }
+    return status;
+}
+
 /******************************************************************
  *              NtOpenIoCompletion (NTDLL.@)
  *              ZwOpenIoCompletion (NTDLL.@)
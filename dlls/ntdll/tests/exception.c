@@ -2040,8 +2040,10 @@ static void test_dynamic_unwind(void)
 {
     static const int code_offset = 1024;
     char buf[sizeof(RUNTIME_FUNCTION) + 4];
+    RUNTIME_FUNCTION runtime_funcs[8];
     RUNTIME_FUNCTION *runtime_func, *func;
     ULONG_PTR table, base;
+    unsigned int i;
     DWORD count;
 
     /* Test RtlAddFunctionTable with aligned RUNTIME_FUNCTION pointer */
@@ -2138,6 +2140,55 @@ static void test_dynamic_unwind(void)
     ok( !pRtlDeleteFunctionTable( (PRUNTIME_FUNCTION)table ),
         "RtlDeleteFunctionTable returned success for nonexistent table = %p\n", (PVOID)table );
 
+    /* Several tables added out of order */
+    for (i = ARRAY_SIZE(runtime_funcs); i > 0; i--)
+    {
+        runtime_funcs[i - 1].BeginAddress = 0;
+        runtime_funcs[i - 1].EndAddress   = 16;
+        runtime_funcs[i - 1].UnwindData   = 0;
+        ok( pRtlAddFunctionTable( &runtime_funcs[i - 1], 1, (ULONG_PTR)code_mem + 64 * (i - 1) ),
+            "RtlAddFunctionTable failed for runtime_funcs[%u]\n", i - 1 );
+    }
+    for (i = 0; i < ARRAY_SIZE(runtime_funcs); i++)
+    {
+        base = 0xdeadbeef;
+        func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + 64 * i + 8, &base, NULL );
+        ok( func == &runtime_funcs[i], "%u: expected %p, got %p\n", i, &runtime_funcs[i], func );
+        ok( base == (ULONG_PTR)code_mem + 64 * i, "%u: got base %lx\n", i, base );
+        func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + 64 * i + 32, &base, NULL );
+        ok( func == NULL, "%u: expected NULL, got %p\n", i, func );
+    }
+    ok( pRtlDeleteFunctionTable( &runtime_funcs[2] ), "RtlDeleteFunctionTable failed\n" );
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + 64 * 2 + 8, &base, NULL );
+    ok( func == NULL, "expected NULL, got %p\n", func );
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + 64 * 3 + 8, &base, NULL );
+    ok( func == &runtime_funcs[3], "expected %p, got %p\n", &runtime_funcs[3], func );
+    for (i = 0; i < ARRAY_SIZE(runtime_funcs); i++)
+        ok( pRtlDeleteFunctionTable( &runtime_funcs[i] ) == (i != 2),
+            "RtlDeleteFunctionTable failed for runtime_funcs[%u]\n", i );
+
+    /* Overlapping tables, the first registered one is used */
+    runtime_funcs[0].BeginAddress = 0;
+    runtime_funcs[0].EndAddress   = 64;
+    runtime_funcs[0].UnwindData   = 0;
+    runtime_funcs[1].BeginAddress = 0;
+    runtime_funcs[1].EndAddress   = 16;
+    runtime_funcs[1].UnwindData   = 0;
+    ok( pRtlAddFunctionTable( &runtime_funcs[0], 1, (ULONG_PTR)code_mem + 64 ),
+        "RtlAddFunctionTable failed for runtime_funcs[0]\n" );
+    ok( pRtlAddFunctionTable( &runtime_funcs[1], 1, (ULONG_PTR)code_mem + 96 ),
+        "RtlAddFunctionTable failed for runtime_funcs[1]\n" );
+    base = 0xdeadbeef;
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + 96 + 8, &base, NULL );
+    ok( func == &runtime_funcs[0], "expected %p, got %p\n", &runtime_funcs[0], func );
+    ok( base == (ULONG_PTR)code_mem + 64, "got base %lx\n", base );
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + 64 + 8, &base, NULL );
+    ok( func == &runtime_funcs[0], "expected %p, got %p\n", &runtime_funcs[0], func );
+    ok( pRtlDeleteFunctionTable( &runtime_funcs[0] ), "RtlDeleteFunctionTable failed\n" );
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + 96 + 8, &base, NULL );
+    ok( func == &runtime_funcs[1], "expected %p, got %p\n", &runtime_funcs[1], func );
+    ok( base == (ULONG_PTR)code_mem + 96, "got base %lx\n", base );
+    ok( pRtlDeleteFunctionTable( &runtime_funcs[1] ), "RtlDeleteFunctionTable failed\n" );
 }
 
 static int termination_handler_called;
@@ -73,6 +73,7 @@ static NTSTATUS (WINAPI *pNtCreateIoCompletion)(PHANDLE, ACCESS_MASK, POBJECT_AT
 static NTSTATUS (WINAPI *pNtOpenIoCompletion)(PHANDLE, ACCESS_MASK, POBJECT_ATTRIBUTES);
 static NTSTATUS (WINAPI *pNtQueryIoCompletion)(HANDLE, IO_COMPLETION_INFORMATION_CLASS, PVOID, ULONG, PULONG);
 static NTSTATUS (WINAPI *pNtRemoveIoCompletion)(HANDLE, PULONG_PTR, PULONG_PTR, PIO_STATUS_BLOCK, PLARGE_INTEGER);
+static NTSTATUS (WINAPI *pNtRemoveIoCompletionEx)(HANDLE, FILE_IO_COMPLETION_INFORMATION *, ULONG, ULONG *, LARGE_INTEGER *, BOOLEAN);
 static NTSTATUS (WINAPI *pNtSetIoCompletion)(HANDLE, ULONG_PTR, ULONG_PTR, NTSTATUS, SIZE_T);
 static NTSTATUS (WINAPI *pNtSetInformationFile)(HANDLE, PIO_STATUS_BLOCK, PVOID, ULONG, FILE_INFORMATION_CLASS);
 static NTSTATUS (WINAPI *pNtQueryInformationFile)(HANDLE, PIO_STATUS_BLOCK, PVOID, ULONG, FILE_INFORMATION_CLASS);
@@ -903,6 +904,49 @@ static void test_iocp_setcompletion(HANDLE h)
     ok( !count, "Unexpected msg count: %d\n", count );
 }
 
+static void test_iocp_remove_ex(HANDLE h)
+{
+    FILE_IO_COMPLETION_INFORMATION info[4];
+    LARGE_INTEGER timeout;
+    NTSTATUS res;
+    ULONG count, i;
+
+    if (!pNtRemoveIoCompletionEx)
+    {
+        win_skip( "NtRemoveIoCompletionEx is not available\n" );
+        return;
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+        res = pNtSetIoCompletion( h, CKEY_FIRST + i, CVALUE_FIRST + i, STATUS_SUCCESS, i );
+        ok( res == STATUS_SUCCESS, "NtSetIoCompletion failed: %x\n", res );
+    }
+
+    timeout.QuadPart = 0;
+    count = 0xdeadbeef;
+    memset( info, 0xcc, sizeof(info) );
+    res = pNtRemoveIoCompletionEx( h, info, 2, &count, &timeout, FALSE );
+    ok( res == STATUS_SUCCESS, "NtRemoveIoCompletionEx failed: %x\n", res );
+    ok( count == 2, "Unexpected msg count: %u\n", count );
+    for (i = 0; i < 2; i++)
+    {
+        ok( info[i].CompletionKey == CKEY_FIRST + i, "%u: Invalid completion key: %lx\n", i, info[i].CompletionKey );
+        ok( info[i].CompletionValue == CVALUE_FIRST + i, "%u: Invalid completion value: %lx\n", i, info[i].CompletionValue );
+        ok( info[i].IoStatusBlock.Information == i, "%u: Invalid Information: %lu\n", i, info[i].IoStatusBlock.Information );
+        ok( U(info[i].IoStatusBlock).Status == STATUS_SUCCESS, "%u: Invalid Status: %x\n", i, U(info[i].IoStatusBlock).Status );
+    }
+
+    count = 0xdeadbeef;
+    res = pNtRemoveIoCompletionEx( h, info, 4, &count, &timeout, FALSE );
+    ok( res == STATUS_SUCCESS, "NtRemoveIoCompletionEx failed: %x\n", res );
+    ok( count == 1, "Unexpected msg count: %u\n", count );
+    ok( info[0].CompletionKey == CKEY_FIRST + 2, "Invalid completion key: %lx\n", info[0].CompletionKey );
+
+    res = pNtRemoveIoCompletionEx( h, info, 4, &count, &timeout, FALSE );
+    ok( res == STATUS_TIMEOUT, "Expected STATUS_TIMEOUT, got %x\n", res );
+}
+
 static void test_iocp_fileio(HANDLE h)
 {
     static const char pipe_name[] = "\\\\.\\pipe\\iocompletiontestnamedpipe";
@@ -2770,6 +2814,7 @@ static void test_iocompletion(void)
     if ( h && h != INVALID_HANDLE_VALUE)
     {
         test_iocp_setcompletion(h);
+        test_iocp_remove_ex(h);
         test_iocp_fileio(h);
         pNtClose(h);
     }
@@ -3055,7 +3100,6 @@ static void test_file_completion_information(void)
     if (!(h = create_temp_file(0))) return;
 
     status = pNtSetInformationFile(h, &io, &info, sizeof(info) - 1, FileIoCompletionNotificationInformation);
-    todo_wine
     ok(status == STATUS_INFO_LENGTH_MISMATCH || status == STATUS_INVALID_INFO_CLASS /* XP */,
        "expected STATUS_INFO_LENGTH_MISMATCH, got %08x\n", status);
     if (status == STATUS_INVALID_INFO_CLASS || status == STATUS_NOT_IMPLEMENTED)
@@ -3170,6 +3214,53 @@ static void test_file_completion_information(void)
     CloseHandle(h);
 }
 
+static void test_skip_set_event_on_handle(void)
+{
+    static const char pipe_name[] = "\\\\.\\pipe\\wine_test_skip_event";
+    FILE_IO_COMPLETION_NOTIFICATION_INFORMATION info;
+    IO_STATUS_BLOCK io;
+    OVERLAPPED ov;
+    NTSTATUS status;
+    HANDLE server, client;
+    DWORD num_bytes, ret;
+    char buf[16];
+    int i;
+
+    server = CreateNamedPipeA(pipe_name, PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED,
+                              PIPE_TYPE_BYTE | PIPE_WAIT, 1, 1024, 1024, 1000, NULL);
+    ok(server != INVALID_HANDLE_VALUE, "CreateNamedPipe failed, error %u\n", GetLastError());
+    client = CreateFileA(pipe_name, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+    ok(client != INVALID_HANDLE_VALUE, "CreateFile failed, error %u\n", GetLastError());
+
+    for (i = 0; i < 2; i++)
+    {
+        if (i)
+        {
+            info.Flags = FILE_SKIP_SET_EVENT_ON_HANDLE;
+            status = pNtSetInformationFile(server, &io, &info, sizeof(info), FileIoCompletionNotificationInformation);
+            ok(status == STATUS_SUCCESS, "expected STATUS_SUCCESS, got %08x\n", status);
+        }
+
+        memset(&ov, 0, sizeof(ov));
+        ret = ReadFile(server, buf, sizeof(buf), &num_bytes, &ov);
+        ok(!ret && GetLastError() == ERROR_IO_PENDING, "ReadFile returned %u, error %u\n", ret, GetLastError());
+        ok(WaitForSingleObject(server, 0) == WAIT_TIMEOUT, "%d: handle is signaled\n", i);
+
+        ret = WriteFile(client, "data", 4, &num_bytes, NULL);
+        ok(ret, "WriteFile failed, error %u\n", GetLastError());
+        while (ov.Internal == STATUS_PENDING) SleepEx(10, TRUE);
+        ok(ov.Internal == STATUS_SUCCESS, "got status %08lx\n", ov.Internal);
+        ok(ov.InternalHigh == 4, "got %lu bytes\n", ov.InternalHigh);
+
+        ret = WaitForSingleObject(server, 0);
+        if (i) ok(ret == WAIT_TIMEOUT, "handle is signaled\n");
+        else ok(ret == WAIT_OBJECT_0, "handle is not signaled\n");
+    }
+
+    CloseHandle(client);
+    CloseHandle(server);
+}
+
 static void test_file_id_information(void)
 {
     BY_HANDLE_FILE_INFORMATION info;
@@ -4285,6 +4376,7 @@ START_TEST(file)
     pNtOpenIoCompletion     = (void *)GetProcAddress(hntdll, "NtOpenIoCompletion");
     pNtQueryIoCompletion    = (void *)GetProcAddress(hntdll, "NtQueryIoCompletion");
     pNtRemoveIoCompletion   = (void *)GetProcAddress(hntdll, "NtRemoveIoCompletion");
+    pNtRemoveIoCompletionEx = (void *)GetProcAddress(hntdll, "NtRemoveIoCompletionEx");
     pNtSetIoCompletion      = (void *)GetProcAddress(hntdll, "NtSetIoCompletion");
     pNtSetInformationFile   = (void *)GetProcAddress(hntdll, "NtSetInformationFile");
     pNtQueryInformationFile = (void *)GetProcAddress(hntdll, "NtQueryInformationFile");
@@ -4312,6 +4404,7 @@ START_TEST(file)
     test_file_link_information();
     test_file_disposition_information();
     test_file_completion_information();
+    test_skip_set_event_on_handle();
     test_file_id_information();
     test_file_access_information();
     test_query_volume_information_file();
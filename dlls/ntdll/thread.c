@@ -365,6 +365,7 @@ HANDLE thread_init(void)
 
     debug_info.str_pos = debug_info.strings;
     debug_info.out_pos = debug_info.output;
+    debug_info.ring    = NULL;
     debug_init();
 
     /* setup the server connection */
@@ -452,6 +453,7 @@ void abort_thread( int status )
  */
 void exit_thread( int status )
 {
+    debug_exit_thread();
     close( ntdll_get_thread_data()->wait_fd[0] );
     close( ntdll_get_thread_data()->wait_fd[1] );
     close( ntdll_get_thread_data()->reply_fd );
@@ -520,6 +522,7 @@ static void start_thread( struct startup_info *info )
 
     debug_info.str_pos = debug_info.strings;
     debug_info.out_pos = debug_info.output;
+    debug_info.ring    = NULL;
     thread_data->debug_info = &debug_info;
     thread_data->pthread_id = pthread_self();
 
@@ -407,23 +407,26 @@ static DWORD CALLBACK iocp_poller(LPVOID Arg)
 
     while( TRUE )
     {
-        PRTL_OVERLAPPED_COMPLETION_ROUTINE callback;
-        LPVOID overlapped;
-        IO_STATUS_BLOCK iosb;
-        NTSTATUS res = NtRemoveIoCompletion( cport, (PULONG_PTR)&callback, (PULONG_PTR)&overlapped, &iosb, NULL );
+        FILE_IO_COMPLETION_INFORMATION info[16];
+        ULONG i, count;
+        NTSTATUS res = NtRemoveIoCompletionEx( cport, info, sizeof(info) / sizeof(info[0]), &count, NULL, FALSE );
         if (res)
         {
-            ERR("NtRemoveIoCompletion failed: 0x%x\n", res);
+            ERR("NtRemoveIoCompletionEx failed: 0x%x\n", res);
+            continue;
         }
-        else
+
+        for (i = 0; i < count; i++)
         {
+            PRTL_OVERLAPPED_COMPLETION_ROUTINE callback = (PRTL_OVERLAPPED_COMPLETION_ROUTINE)info[i].CompletionKey;
+            LPVOID overlapped = (LPVOID)info[i].CompletionValue;
             DWORD transferred = 0;
             DWORD err = 0;
 
-            if (iosb.u.Status == STATUS_SUCCESS)
-                transferred = iosb.Information;
+            if (info[i].IoStatusBlock.u.Status == STATUS_SUCCESS)
+                transferred = info[i].IoStatusBlock.Information;
             else
-                err = RtlNtStatusToDosError(iosb.u.Status);
+                err = RtlNtStatusToDosError(info[i].IoStatusBlock.u.Status);
 
             callback( err, transferred, overlapped );
         }
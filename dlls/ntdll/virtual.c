@@ -1352,13 +1352,32 @@ static NTSTATUS map_pe_header( void *ptr, size_t size, int fd, BOOL *removable )
 }
 
 
+/***********************************************************************
+ *           is_file_unchanged
+ *
+ * Check that a file still has the size and modification time it had when
+ * a copy of it was made.
+ */
+static BOOL is_file_unchanged( int fd, ULONGLONG size, ULONGLONG mtime )
+{
+    struct stat st;
+    LARGE_INTEGER time;
+
+    if (fstat( fd, &st ) == -1) return FALSE;
+    RtlSecondsSince1970ToTime( st.st_mtime, &time );
+    return st.st_size == size && time.QuadPart == mtime;
+}
+
+
 /***********************************************************************
  *           map_image
  *
  * Map an executable (PE format) image into memory.
  */
 static NTSTATUS map_image( HANDLE hmapping, ACCESS_MASK access, int fd, SIZE_T mask,
-                           pe_image_info_t *image_info, int shared_fd, BOOL removable, PVOID *addr_ptr )
+                           pe_image_info_t *image_info, int shared_fd, int relocated_fd,
+                           char *relocated_base, ULONGLONG relocated_size, ULONGLONG relocated_mtime,
+                           BOOL removable, PVOID *addr_ptr )
 {
     IMAGE_DOS_HEADER *dos;
     IMAGE_NT_HEADERS *nt;
@@ -1374,6 +1393,7 @@ static NTSTATUS map_image( HANDLE hmapping, ACCESS_MASK access, int fd, SIZE_T m
     struct file_view *view = NULL;
     char *ptr, *header_end, *header_start;
     char *base = wine_server_get_ptr( image_info->base );
+    BOOL relocated = FALSE;
 
     if (total_size != image_info->map_size)  /* truncated */
     {
@@ -1390,6 +1410,18 @@ static NTSTATUS map_image( HANDLE hmapping, ACCESS_MASK access, int fd, SIZE_T m
         status = map_view( &view, base, total_size, mask, FALSE, SEC_IMAGE | SEC_FILE |
                            VPROT_COMMITTED | VPROT_READ | VPROT_EXEC | VPROT_WRITECOPY );
 
+    /* if another process already relocated the image, try to reuse its copy */
+    if (status != STATUS_SUCCESS && relocated_fd != -1 &&
+        relocated_base >= (char *)address_space_start &&
+        !(image_info->image_flags & IMAGE_FLAGS_ImageMappedFlat) &&
+        is_file_unchanged( fd, relocated_size, relocated_mtime ) &&
+        !fstat( relocated_fd, &st ) && st.st_size >= total_size)
+    {
+        status = map_view( &view, relocated_base, total_size, mask, FALSE, SEC_IMAGE | SEC_FILE |
+                           VPROT_COMMITTED | VPROT_READ | VPROT_EXEC | VPROT_WRITECOPY );
+        relocated = (status == STATUS_SUCCESS);
+    }
+
     if (status != STATUS_SUCCESS)
         status = map_view( &view, NULL, total_size, mask, FALSE, SEC_IMAGE | SEC_FILE |
                            VPROT_COMMITTED | VPROT_READ | VPROT_EXEC | VPROT_WRITECOPY );
@@ -1453,6 +1485,19 @@ static NTSTATUS map_image( HANDLE hmapping, ACCESS_MASK access, int fd, SIZE_T m
     }
 
 
+    /* the relocated copy contains all the sections at their final position */
+
+    if (relocated)
+    {
+        TRACE_(module)( "mapping relocated copy at %p\n", ptr );
+        if (map_file_into_view( view, relocated_fd, 0, total_size, 0,
+                                VPROT_COMMITTED | VPROT_READ | VPROT_WRITECOPY, FALSE ) != STATUS_SUCCESS)
+        {
+            ERR_(module)( "Could not map relocated copy\n" );
+            goto error;
+        }
+    }
+
     /* map all the sections */
 
     for (i = pos = 0; i < nt->FileHeader.NumberOfSections; i++, sec++)
@@ -1509,6 +1554,8 @@ static NTSTATUS map_image( HANDLE hmapping, ACCESS_MASK access, int fd, SIZE_T m
             continue;
         }
 
+        if (relocated) continue;
+
         TRACE_(module)( "mapping section %.8s at %p off %x size %x virt %x flags %x\n",
                         sec->Name, ptr + sec->VirtualAddress,
                         sec->PointerToRawData, sec->SizeOfRawData,
@@ -1618,7 +1665,9 @@ NTSTATUS virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG zero_bits, S
     int unix_handle = -1, needs_close;
     unsigned int vprot, sec_flags;
     struct file_view *view;
-    HANDLE shared_file;
+    HANDLE shared_file, relocated_mapping;
+    client_ptr_t relocated_base;
+    ULONGLONG relocated_size, relocated_mtime;
     LARGE_INTEGER offset;
     sigset_t sigset;
 
@@ -1655,34 +1704,53 @@ NTSTATUS virtual_map_section( HANDLE handle, PVOID *addr_ptr, ULONG zero_bits, S
         sec_flags   = reply->flags;
         full_size   = reply->size;
         shared_file = wine_server_ptr_handle( reply->shared_file );
+        relocated_base    = reply->relocated_base;
+        relocated_size    = reply->relocated_size;
+        relocated_mtime   = reply->relocated_mtime;
+        relocated_mapping = wine_server_ptr_handle( reply->relocated_mapping );
     }
     SERVER_END_REQ;
     if (res) return res;
 
-    if ((res = server_get_unix_fd( handle, 0, &unix_handle, &needs_close, NULL, NULL ))) goto done;
+    if ((res = server_get_unix_fd( handle, 0, &unix_handle, &needs_close, NULL, NULL )))
+    {
+        if (shared_file) close_handle( shared_file );
+        if (relocated_mapping) close_handle( relocated_mapping );
+        return res;
+    }
 
     if (sec_flags & SEC_IMAGE)
     {
+        int shared_fd = -1, shared_needs_close = 0;
+        int relocated_fd = -1, relocated_needs_close = 0;
+
         if (shared_file)
         {
-            int shared_fd, shared_needs_close;
-
-            if ((res = server_get_unix_fd( shared_file, FILE_READ_DATA|FILE_WRITE_DATA,
-                                           &shared_fd, &shared_needs_close, NULL, NULL ))) goto done;
-            res = map_image( handle, access, unix_handle, mask, image_info,
-                             shared_fd, needs_close, addr_ptr );
-            if (shared_needs_close) close( shared_fd );
+            res = server_get_unix_fd( shared_file, FILE_READ_DATA|FILE_WRITE_DATA,
+                                      &shared_fd, &shared_needs_close, NULL, NULL );
             close_handle( shared_file );
         }
-        else
+        if (relocated_mapping)
         {
-            res = map_image( handle, access, unix_handle, mask, image_info, -1, needs_close, addr_ptr );
+            /* not fatal, the image gets mapped from the file instead */
+            if (server_get_unix_fd( relocated_mapping, 0, &relocated_fd, &relocated_needs_close, NULL, NULL ))
+                relocated_fd = -1;
+            close_handle( relocated_mapping );
         }
+        if (!res)
+            res = map_image( handle, access, unix_handle, mask, image_info, shared_fd,
+                             relocated_fd, wine_server_get_ptr( relocated_base ), relocated_size,
+                             relocated_mtime, needs_close, addr_ptr );
+        if (shared_needs_close) close( shared_fd );
+        if (relocated_needs_close) close( relocated_fd );
         if (needs_close) close( unix_handle );
         if (res >= 0) *size_ptr = image_info->map_size;
         return res;
     }
 
+    if (shared_file) close_handle( shared_file );
+    if (relocated_mapping) close_handle( relocated_mapping );
+
     res = STATUS_INVALID_PARAMETER;
     if (offset.QuadPart >= full_size) goto done;
     if (*size_ptr)
@@ -52,6 +52,9 @@ typedef struct FileLockBytesImpl
     HANDLE hfile;
     DWORD flProtect;
     LPWSTR pwcsName;
+    BOOL can_map;        /* file contents can't change behind our back */
+    BYTE *view;          /* read-only view of the whole file, if mapped */
+    ULONGLONG view_size;
 } FileLockBytesImpl;
 
 static const ILockBytesVtbl FileLockBytesImpl_Vtbl;
@@ -104,6 +107,14 @@ HRESULT FileLockBytesImpl_Construct(HANDLE hFile, DWORD openFlags, LPCWSTR pwcsN
   This->ref = 1;
   This->hfile = hFile;
   This->flProtect = GetProtectMode(openFlags);
+  This->view = NULL;
+  This->view_size = 0;
+
+  /* Read-only files that nobody else may write to can be served from a
+   * mapping of the whole file instead of a seek and read per sector. */
+  This->can_map = This->flProtect == PAGE_READONLY &&
+                  (STGM_SHARE_MODE(openFlags) == STGM_SHARE_DENY_WRITE ||
+                   STGM_SHARE_MODE(openFlags) == STGM_SHARE_EXCLUSIVE);
 
   if(pwcsName) {
     if (!GetFullPathNameW(pwcsName, MAX_PATH, fullpath, NULL))
@@ -127,6 +138,47 @@ HRESULT FileLockBytesImpl_Construct(HANDLE hFile, DWORD openFlags, LPCWSTR pwcsN
   return S_OK;
 }
 
+/******************************************************************************
+ *      FileLockBytesImpl_MapView
+ *
+ * Map the whole file for reading. Returns FALSE if reads have to go
+ * through ReadFile.
+ */
+static BOOL FileLockBytesImpl_MapView(FileLockBytesImpl *This)
+{
+    LARGE_INTEGER size;
+    HANDLE mapping;
+
+    if (This->view) return TRUE;
+    if (!This->can_map) return FALSE;
+
+    /* don't try again, whatever the outcome */
+    This->can_map = FALSE;
+
+    if (!GetFileSizeEx(This->hfile, &size) || !size.QuadPart ||
+        size.QuadPart != (SIZE_T)size.QuadPart)
+        return FALSE;
+
+    mapping = CreateFileMappingW(This->hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        WARN("failed to create mapping, error %u\n", GetLastError());
+        return FALSE;
+    }
+
+    This->view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!This->view)
+    {
+        WARN("failed to map view, error %u\n", GetLastError());
+        return FALSE;
+    }
+
+    This->view_size = size.QuadPart;
+    TRACE("(%p) mapped %s bytes at %p\n", This, wine_dbgstr_longlong(This->view_size), This->view);
+    return TRUE;
+}
+
 /* ILockByte Interfaces */
 
 static HRESULT WINAPI FileLockBytesImpl_QueryInterface(ILockBytes *iface, REFIID riid,
@@ -160,6 +212,7 @@ static ULONG WINAPI FileLockBytesImpl_Release(ILockBytes *iface)
 
     if (ref == 0)
     {
+        if (This->view) UnmapViewOfFile(This->view);
         CloseHandle(This->hfile);
         HeapFree(GetProcessHeap(), 0, This->pwcsName);
         HeapFree(GetProcessHeap(), 0, This);
@@ -198,6 +251,22 @@ static HRESULT WINAPI FileLockBytesImpl_ReadAt(
     if (pcbRead)
         *pcbRead = 0;
 
+    if (FileLockBytesImpl_MapView(This))
+    {
+        ULONG count = 0;
+
+        if (ulOffset.QuadPart < This->view_size)
+        {
+            count = min(cb, This->view_size - ulOffset.QuadPart);
+            memcpy(pv, This->view + ulOffset.QuadPart, count);
+        }
+
+        if (pcbRead)
+            *pcbRead = count;
+
+        return count == cb ? S_OK : STG_E_READFAULT;
+    }
+
     offset.QuadPart = ulOffset.QuadPart;
 
     ret = SetFilePointerEx(This->hfile, offset, NULL, FILE_BEGIN);
@@ -207,6 +207,7 @@ struct BlockChainStream
   struct BlockChainRun* indexCache;
   ULONG        indexCacheLen;
   ULONG        indexCacheSize;
+  ULONG        lastRun;
   BlockChainBlock cachedBlocks[2];
   ULONG        blockToEvict;
   ULONG        tailIndex;
@@ -4031,6 +4032,7 @@ static HRESULT StorageImpl_GetNextBlockInChain(
   ULONG read;
   ULONG depotBlockIndexPos;
   int index, num_blocks;
+  struct BlockDepotCacheEntry *cached;
 
   *nextBlockIndex   = BLOCK_SPECIAL;
 
@@ -4041,12 +4043,14 @@ static HRESULT StorageImpl_GetNextBlockInChain(
     return STG_E_READFAULT;
   }
 
+  cached = &This->blockDepotCache[depotBlockCount % BLOCKDEPOT_CACHE_SIZE];
+
   /*
    * Cache the currently accessed depot block.
    */
-  if (depotBlockCount != This->indexBlockDepotCached)
+  if (depotBlockCount != cached->index)
   {
-    This->indexBlockDepotCached = depotBlockCount;
+    cached->index = depotBlockCount;
 
     if (depotBlockCount < COUNT_BBDEPOTINHEADER)
     {
@@ -4063,18 +4067,21 @@ static HRESULT StorageImpl_GetNextBlockInChain(
     StorageImpl_ReadBigBlock(This, depotBlockIndexPos, depotBuffer, &read);
 
     if (!read)
+    {
+      cached->index = 0xFFFFFFFF;
       return STG_E_READFAULT;
+    }
 
     num_blocks = This->bigBlockSize / 4;
 
     for (index = 0; index < num_blocks; index++)
     {
       StorageUtl_ReadDWord(depotBuffer, index*sizeof(ULONG), nextBlockIndex);
-      This->blockDepotCached[index] = *nextBlockIndex;
+      cached->entries[index] = *nextBlockIndex;
     }
   }
 
-  *nextBlockIndex = This->blockDepotCached[depotBlockOffset/sizeof(ULONG)];
+  *nextBlockIndex = cached->entries[depotBlockOffset/sizeof(ULONG)];
 
   return S_OK;
 }
@@ -4156,9 +4163,9 @@ static void StorageImpl_SetNextBlockInChain(
   /*
    * Update the cached block depot, if necessary.
    */
-  if (depotBlockCount == This->indexBlockDepotCached)
+  if (depotBlockCount == This->blockDepotCache[depotBlockCount % BLOCKDEPOT_CACHE_SIZE].index)
   {
-    This->blockDepotCached[depotBlockOffset/sizeof(ULONG)] = nextBlock;
+    This->blockDepotCache[depotBlockCount % BLOCKDEPOT_CACHE_SIZE].entries[depotBlockOffset/sizeof(ULONG)] = nextBlock;
   }
 }
 
@@ -4627,6 +4634,7 @@ static HRESULT StorageImpl_Refresh(StorageImpl *This, BOOL new_object, BOOL crea
   DirEntry currentEntry;
   DirRef      currentEntryRef;
   BlockChainStream *blockChainStream;
+  int i;
 
   if (create)
   {
@@ -4693,7 +4701,8 @@ static HRESULT StorageImpl_Refresh(StorageImpl *This, BOOL new_object, BOOL crea
   /*
    * There is no block depot cached yet.
    */
-  This->indexBlockDepotCached = 0xFFFFFFFF;
+  for (i = 0; i < BLOCKDEPOT_CACHE_SIZE; i++)
+    This->blockDepotCache[i].index = 0xFFFFFFFF;
   This->indexExtBlockDepotCached = 0xFFFFFFFF;
 
   /*
@@ -7191,6 +7200,12 @@ static ULONG BlockChainStream_GetSectorOfOffset(BlockChainStream *This, ULONG of
   if (offset >= This->numBlocks)
     return BLOCK_END_OF_CHAIN;
 
+  /* Sequential access usually stays in the same run. */
+  if (This->lastRun < This->indexCacheLen &&
+      offset >= This->indexCache[This->lastRun].firstOffset &&
+      offset <= This->indexCache[This->lastRun].lastOffset)
+    min_run = max_run = This->lastRun;
+
   while (min_run < max_run)
   {
     ULONG run_to_check = min_run + (offset - min_offset) * (max_run - min_run) / (max_offset - min_offset);
@@ -7209,9 +7224,15 @@ static ULONG BlockChainStream_GetSectorOfOffset(BlockChainStream *This, ULONG of
       min_run = max_run = run_to_check;
   }
 
+  This->lastRun = min_run;
   return This->indexCache[min_run].firstSector + offset - This->indexCache[min_run].firstOffset;
 }
 
+static BOOL BlockChainStream_IsBlockCached(BlockChainStream *This, ULONG index)
+{
+  return This->cachedBlocks[0].index == index || This->cachedBlocks[1].index == index;
+}
+
 static HRESULT BlockChainStream_GetBlockAtOffset(BlockChainStream *This,
     ULONG index, BlockChainBlock **block, ULONG *sector, BOOL create)
 {
@@ -7276,6 +7297,7 @@ BlockChainStream* BlockChainStream_Construct(
   newStream->indexCache              = NULL;
   newStream->indexCacheLen           = 0;
   newStream->indexCacheSize          = 0;
+  newStream->lastRun                 = 0;
   newStream->cachedBlocks[0].index = 0xffffffff;
   newStream->cachedBlocks[0].dirty = FALSE;
   newStream->cachedBlocks[1].index = 0xffffffff;
@@ -7656,7 +7678,20 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
 
     if (!cachedBlock)
     {
-      /* Not in cache, and we're going to read past the end of the block. */
+      /* Not in cache, and we're going to read past the end of the block.
+       * Following blocks that are consecutive on disk are read at once, up
+       * to the last one which goes through the cache. */
+      ULONG count = 1;
+
+      while (bytesToReadInBuffer + This->parentStorage->bigBlockSize < size &&
+             BlockChainStream_GetSectorOfOffset(This, blockNoInSequence + count) == blockIndex + count &&
+             !BlockChainStream_IsBlockCached(This, blockNoInSequence + count))
+      {
+        bytesToReadInBuffer += This->parentStorage->bigBlockSize;
+        count++;
+      }
+      blockNoInSequence += count - 1;
+
       ulOffset.QuadPart = StorageImpl_GetBigBlockOffset(This->parentStorage, blockIndex) +
                                offsetInBlock;
 
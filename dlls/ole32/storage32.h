@@ -361,6 +361,7 @@ void StorageBaseImpl_RemoveStream(StorageBaseImpl * stg, StgStreamImpl * strm) D
 
 /* Number of BlockChainStream objects to cache in a StorageImpl */
 #define BLOCKCHAIN_CACHE_SIZE 4
+#define BLOCKDEPOT_CACHE_SIZE 16
 
 /****************************************************************************
  * StorageImpl definitions.
@@ -393,8 +394,14 @@ struct StorageImpl
   ULONG extBlockDepotCached[MAX_BIG_BLOCK_SIZE / 4];
   ULONG indexExtBlockDepotCached;
 
-  ULONG blockDepotCached[MAX_BIG_BLOCK_SIZE / 4];
-  ULONG indexBlockDepotCached;
+  /* Recently used big block depot sectors, indexed by depot block number
+   * modulo BLOCKDEPOT_CACHE_SIZE, so that walking chains spread over the
+   * whole file doesn't keep re-reading the same sectors. */
+  struct BlockDepotCacheEntry
+  {
+    ULONG index;
+    ULONG entries[MAX_BIG_BLOCK_SIZE / 4];
+  } blockDepotCache[BLOCKDEPOT_CACHE_SIZE];
   ULONG prevFreeBlock;
 
   /* All small blocks before this one are known to be in use. */
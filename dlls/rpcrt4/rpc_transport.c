@@ -59,6 +59,7 @@
 WINE_DEFAULT_DEBUG_CHANNEL(rpc);
 
 static RpcConnection *rpcrt4_spawn_connection(RpcConnection *old_connection);
+static RPC_STATUS rpcrt4_ncalrpc_offer_shm(RpcConnection *conn);
 
 /**** ncacn_np support ****/
 
@@ -71,6 +72,8 @@ typedef struct _RpcConnection_np
     IO_STATUS_BLOCK io_status;
     HANDLE event_cache;
     BOOL read_closed;
+    struct lrpc_shm *shm;   /* ncalrpc only, NULL when data goes through the pipe */
+    BOOL shm_checked;       /* ncalrpc server only, first packet has been examined */
 } RpcConnection_np;
 
 static RpcConnection *rpcrt4_conn_np_alloc(void)
@@ -200,6 +203,15 @@ static RPC_STATUS rpcrt4_ncalrpc_open(RpcConnection* Connection)
 
   pname = ncalrpc_pipe_name(Connection->Endpoint);
   r = rpcrt4_conn_open_pipe(Connection, pname, TRUE);
+  if (r == RPC_S_OK && rpcrt4_ncalrpc_offer_shm(Connection) != RPC_S_OK)
+  {
+    /* the server closed the pipe on our offer, so it doesn't know about
+     * shared memory transport; reconnect and stick to the pipe */
+    TRACE("falling back to named pipe transport\n");
+    CloseHandle(npc->pipe);
+    npc->pipe = 0;
+    r = rpcrt4_conn_open_pipe(Connection, pname, TRUE);
+  }
   I_RpcFree(pname);
 
   return r;
@@ -897,6 +909,378 @@ static RPC_STATUS rpcrt4_ncalrpc_inquire_auth_client(
     return RPC_S_OK;
 }
 
+/**** ncalrpc shared memory support ****/
+
+/* The named pipe of an ncalrpc connection is only used to set up a section
+ * holding one ring buffer per direction; packets are then copied through the
+ * rings and only the wake-ups go through the server. The client offers the
+ * section with a pseudo packet that can never be a valid DCE/RPC header, so
+ * servers that don't know about it drop the connection and the client
+ * reconnects using the plain pipe transport. */
+
+#define LRPC_SHM_VERSION   0xff  /* never a valid rpc_ver */
+#define LRPC_SHM_MAGIC     0x4d48534c
+#define LRPC_SHM_RING_SIZE 0x10000
+
+enum lrpc_shm_event
+{
+    LRPC_SHM_DATA,    /* data was written to the ring */
+    LRPC_SHM_SPACE,   /* data was consumed from the ring */
+    LRPC_SHM_EVENT_COUNT
+};
+
+struct lrpc_shm_ring
+{
+    LONG head;            /* total bytes written */
+    LONG tail;            /* total bytes read */
+    LONG data_waiting;    /* reader is waiting for the data event */
+    LONG space_waiting;   /* writer is waiting for the space event */
+    LONG closed;
+    unsigned char data[LRPC_SHM_RING_SIZE];
+};
+
+/* ring 0 carries client to server packets, ring 1 server to client ones */
+struct lrpc_shm_area
+{
+    struct lrpc_shm_ring ring[2];
+};
+
+struct lrpc_shm_offer
+{
+    unsigned char rpc_ver;
+    unsigned char rpc_ver_minor;
+    unsigned short reserved;
+    DWORD magic;
+    DWORD size;
+    DWORD status;
+    DWORD section;
+    DWORD events[2][LRPC_SHM_EVENT_COUNT];
+};
+
+struct lrpc_shm
+{
+    struct lrpc_shm_area *area;
+    struct lrpc_shm_ring *in;
+    struct lrpc_shm_ring *out;
+    HANDLE events[2][LRPC_SHM_EVENT_COUNT];
+    HANDLE in_data;
+    HANDLE in_space;
+    HANDLE out_data;
+    HANDLE out_space;
+    HANDLE peer;
+    HANDLE cancel_event;
+};
+
+static void lrpc_shm_free(struct lrpc_shm *shm)
+{
+    unsigned int i, j;
+
+    if (shm->area) UnmapViewOfFile(shm->area);
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < LRPC_SHM_EVENT_COUNT; j++)
+            if (shm->events[i][j]) CloseHandle(shm->events[i][j]);
+    if (shm->peer) CloseHandle(shm->peer);
+    if (shm->cancel_event) CloseHandle(shm->cancel_event);
+    HeapFree(GetProcessHeap(), 0, shm);
+}
+
+static void lrpc_shm_init_rings(struct lrpc_shm *shm, BOOL server)
+{
+    shm->in = &shm->area->ring[server ? 0 : 1];
+    shm->out = &shm->area->ring[server ? 1 : 0];
+    shm->in_data = shm->events[server ? 0 : 1][LRPC_SHM_DATA];
+    shm->in_space = shm->events[server ? 0 : 1][LRPC_SHM_SPACE];
+    shm->out_data = shm->events[server ? 1 : 0][LRPC_SHM_DATA];
+    shm->out_space = shm->events[server ? 1 : 0][LRPC_SHM_SPACE];
+}
+
+/* returns FALSE if the call was cancelled or the peer went away */
+static BOOL lrpc_shm_wait(struct lrpc_shm *shm, HANDLE event)
+{
+    HANDLE handles[3];
+
+    handles[0] = event;
+    handles[1] = shm->cancel_event;
+    handles[2] = shm->peer;
+    return WaitForMultipleObjects(3, handles, FALSE, INFINITE) == WAIT_OBJECT_0;
+}
+
+static int lrpc_shm_read(RpcConnection_np *npc, void *buffer, unsigned int count)
+{
+    struct lrpc_shm *shm = npc->shm;
+    struct lrpc_shm_ring *ring = shm->in;
+    unsigned int bytes_read = 0;
+
+    while (bytes_read < count)
+    {
+        ULONG tail = ring->tail;
+        ULONG avail = InterlockedCompareExchange(&ring->head, 0, 0) - tail;
+
+        /* the ring is writable by the peer, don't trust its positions */
+        if (avail > LRPC_SHM_RING_SIZE)
+        {
+            WARN("invalid ring positions %x/%x\n", ring->head, tail);
+            return -1;
+        }
+
+        if (avail)
+        {
+            unsigned int len = min(avail, count - bytes_read);
+            unsigned int pos = tail % LRPC_SHM_RING_SIZE;
+            unsigned int first = min(len, LRPC_SHM_RING_SIZE - pos);
+
+            memcpy((char *)buffer + bytes_read, ring->data + pos, first);
+            memcpy((char *)buffer + bytes_read + first, ring->data, len - first);
+            InterlockedExchangeAdd(&ring->tail, len);
+            bytes_read += len;
+            if (InterlockedExchange(&ring->space_waiting, 0))
+                SetEvent(shm->in_space);
+            continue;
+        }
+
+        if (npc->read_closed || ring->closed) return -1;
+
+        /* check again after announcing ourselves to avoid missing a wake-up */
+        InterlockedExchange(&ring->data_waiting, 1);
+        if ((ULONG)ring->head != tail || ring->closed) continue;
+        if (!lrpc_shm_wait(shm, shm->in_data)) return -1;
+    }
+    return bytes_read;
+}
+
+static int lrpc_shm_write(RpcConnection_np *npc, const void *buffer, unsigned int count)
+{
+    struct lrpc_shm *shm = npc->shm;
+    struct lrpc_shm_ring *ring = shm->out;
+    unsigned int bytes_written = 0;
+
+    while (bytes_written < count)
+    {
+        ULONG head = ring->head;
+        ULONG used = head - InterlockedCompareExchange(&ring->tail, 0, 0);
+        ULONG space;
+
+        if (ring->closed) return -1;
+        if (used > LRPC_SHM_RING_SIZE)
+        {
+            WARN("invalid ring positions %x/%x\n", head, ring->tail);
+            return -1;
+        }
+        space = LRPC_SHM_RING_SIZE - used;
+
+        if (space)
+        {
+            unsigned int len = min(space, count - bytes_written);
+            unsigned int pos = head % LRPC_SHM_RING_SIZE;
+            unsigned int first = min(len, LRPC_SHM_RING_SIZE - pos);
+
+            memcpy(ring->data + pos, (const char *)buffer + bytes_written, first);
+            memcpy(ring->data, (const char *)buffer + bytes_written + first, len - first);
+            InterlockedExchangeAdd(&ring->head, len);
+            bytes_written += len;
+            if (InterlockedExchange(&ring->data_waiting, 0))
+                SetEvent(shm->out_data);
+            continue;
+        }
+
+        InterlockedExchange(&ring->space_waiting, 1);
+        if ((ULONG)ring->tail != head - LRPC_SHM_RING_SIZE || ring->closed) continue;
+        if (!lrpc_shm_wait(shm, shm->out_space)) return -1;
+    }
+    return bytes_written;
+}
+
+static void lrpc_shm_close(struct lrpc_shm *shm)
+{
+    /* wake up the peer, whatever it is waiting for */
+    InterlockedExchange(&shm->in->closed, 1);
+    InterlockedExchange(&shm->out->closed, 1);
+    SetEvent(shm->out_data);
+    SetEvent(shm->in_space);
+    lrpc_shm_free(shm);
+}
+
+static RPC_STATUS rpcrt4_ncalrpc_offer_shm(RpcConnection *conn)
+{
+    RpcConnection_np *npc = (RpcConnection_np *)conn;
+    struct lrpc_shm_offer offer, reply;
+    struct lrpc_shm *shm;
+    HANDLE section = 0;
+    ULONG pid;
+    unsigned int i, j;
+
+    if (!GetNamedPipeServerProcessId(npc->pipe, &pid))
+        return RPC_S_OK;
+
+    if (!(shm = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*shm))))
+        return RPC_S_OK;
+    if (!(shm->peer = OpenProcess(SYNCHRONIZE, FALSE, pid)) ||
+        !(shm->cancel_event = CreateEventW(NULL, FALSE, FALSE, NULL)))
+        goto done;
+
+    if (!(section = CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0,
+                                       sizeof(struct lrpc_shm_area), NULL)))
+        goto done;
+    shm->area = MapViewOfFile(section, FILE_MAP_WRITE, 0, 0, 0);
+    memset(&offer, 0, sizeof(offer));
+    offer.section = HandleToULong(section);
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < LRPC_SHM_EVENT_COUNT; j++)
+        {
+            if (!(shm->events[i][j] = CreateEventW(NULL, FALSE, FALSE, NULL))) goto done;
+            offer.events[i][j] = HandleToULong(shm->events[i][j]);
+        }
+    if (!shm->area) goto done;
+
+    offer.rpc_ver = LRPC_SHM_VERSION;
+    offer.magic = LRPC_SHM_MAGIC;
+    offer.size = sizeof(struct lrpc_shm_area);
+
+    /* the server duplicates our handles before it replies */
+    if (rpcrt4_conn_np_write(conn, &offer, sizeof(offer)) != sizeof(offer) ||
+        rpcrt4_conn_np_read(conn, &reply, sizeof(reply)) != sizeof(reply) ||
+        reply.magic != LRPC_SHM_MAGIC)
+    {
+        CloseHandle(section);
+        lrpc_shm_free(shm);
+        return RPC_S_SERVER_UNAVAILABLE;
+    }
+    if (reply.status == RPC_S_OK)
+    {
+        TRACE("using shared memory transport\n");
+        lrpc_shm_init_rings(shm, FALSE);
+        npc->shm = shm;
+        shm = NULL;
+    }
+    else
+        WARN("server refused shared memory transport: %u\n", reply.status);
+
+done:
+    if (section) CloseHandle(section);
+    if (shm) lrpc_shm_free(shm);
+    return RPC_S_OK;
+}
+
+/* called on the first read of a server connection; buffer already holds the
+ * start of the offer */
+static void rpcrt4_ncalrpc_accept_shm(RpcConnection_np *npc, const void *buffer, unsigned int count)
+{
+    struct lrpc_shm_offer offer;
+    struct lrpc_shm *shm = NULL;
+    HANDLE process = 0, section = 0;
+    ULONG pid;
+    unsigned int i, j;
+    RPC_STATUS status = RPC_S_OUT_OF_RESOURCES;
+
+    memcpy(&offer, buffer, count);
+    if ((count < sizeof(offer) &&
+         rpcrt4_conn_np_read(&npc->common, (char *)&offer + count, sizeof(offer) - count) != sizeof(offer) - count) ||
+        offer.magic != LRPC_SHM_MAGIC)
+    {
+        WARN("invalid shared memory offer\n");
+        return;
+    }
+
+    if (offer.size != sizeof(struct lrpc_shm_area))
+        status = RPC_S_PROTOCOL_ERROR;
+    else if (GetNamedPipeClientProcessId(npc->pipe, &pid) &&
+             (process = OpenProcess(PROCESS_DUP_HANDLE | SYNCHRONIZE, FALSE, pid)) &&
+             (shm = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*shm))) &&
+             (shm->cancel_event = CreateEventW(NULL, FALSE, FALSE, NULL)) &&
+             DuplicateHandle(process, ULongToHandle(offer.section), GetCurrentProcess(), &section,
+                             0, FALSE, DUPLICATE_SAME_ACCESS) &&
+             (shm->area = MapViewOfFile(section, FILE_MAP_WRITE, 0, 0, 0)))
+    {
+        shm->peer = process;
+        process = 0;
+        status = RPC_S_OK;
+        for (i = 0; i < 2; i++)
+            for (j = 0; j < LRPC_SHM_EVENT_COUNT; j++)
+                if (!DuplicateHandle(shm->peer, ULongToHandle(offer.events[i][j]), GetCurrentProcess(),
+                                     &shm->events[i][j], 0, FALSE, DUPLICATE_SAME_ACCESS))
+                    status = RPC_S_OUT_OF_RESOURCES;
+    }
+
+    offer.status = status;
+    if (rpcrt4_conn_np_write(&npc->common, &offer, sizeof(offer)) != sizeof(offer))
+        status = RPC_S_CALL_FAILED;
+
+    if (status == RPC_S_OK)
+    {
+        TRACE("using shared memory transport\n");
+        lrpc_shm_init_rings(shm, TRUE);
+        npc->shm = shm;
+    }
+    else if (shm)
+        lrpc_shm_free(shm);
+    if (section) CloseHandle(section);
+    if (process) CloseHandle(process);
+}
+
+static int rpcrt4_conn_ncalrpc_read(RpcConnection *conn, void *buffer, unsigned int count)
+{
+    RpcConnection_np *npc = (RpcConnection_np *)conn;
+    int r;
+
+    if (npc->shm) return lrpc_shm_read(npc, buffer, count);
+
+    r = rpcrt4_conn_np_read(conn, buffer, count);
+    if (conn->server && !npc->shm_checked)
+    {
+        npc->shm_checked = TRUE;
+        if (r > 0 && r <= sizeof(struct lrpc_shm_offer) && *(unsigned char *)buffer == LRPC_SHM_VERSION)
+        {
+            rpcrt4_ncalrpc_accept_shm(npc, buffer, r);
+            /* the offer wasn't what the caller asked for, try again */
+            r = rpcrt4_conn_ncalrpc_read(conn, buffer, count);
+        }
+    }
+    return r;
+}
+
+static int rpcrt4_conn_ncalrpc_write(RpcConnection *conn, const void *buffer, unsigned int count)
+{
+    RpcConnection_np *npc = (RpcConnection_np *)conn;
+
+    if (npc->shm) return lrpc_shm_write(npc, buffer, count);
+    return rpcrt4_conn_np_write(conn, buffer, count);
+}
+
+static int rpcrt4_conn_ncalrpc_close(RpcConnection *conn)
+{
+    RpcConnection_np *npc = (RpcConnection_np *)conn;
+
+    if (npc->shm)
+    {
+        lrpc_shm_close(npc->shm);
+        npc->shm = NULL;
+    }
+    return rpcrt4_conn_np_close(conn);
+}
+
+static void rpcrt4_conn_ncalrpc_close_read(RpcConnection *conn)
+{
+    RpcConnection_np *npc = (RpcConnection_np *)conn;
+
+    if (npc->shm)
+    {
+        npc->read_closed = TRUE;
+        SetEvent(npc->shm->in_data);
+        return;
+    }
+    rpcrt4_conn_np_close_read(conn);
+}
+
+static void rpcrt4_conn_ncalrpc_cancel_call(RpcConnection *conn)
+{
+    RpcConnection_np *npc = (RpcConnection_np *)conn;
+
+    if (npc->shm)
+        SetEvent(npc->shm->cancel_event);
+    else
+        rpcrt4_conn_np_cancel_call(conn);
+}
+
 /**** ncacn_ip_tcp support ****/
 
 static size_t rpcrt4_ip_tcp_get_top_of_tower(unsigned char *tower_data,
@@ -3162,11 +3546,11 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_alloc,
     rpcrt4_ncalrpc_open,
     rpcrt4_ncalrpc_handoff,
-    rpcrt4_conn_np_read,
-    rpcrt4_conn_np_write,
-    rpcrt4_conn_np_close,
-    rpcrt4_conn_np_close_read,
-    rpcrt4_conn_np_cancel_call,
+    rpcrt4_conn_ncalrpc_read,
+    rpcrt4_conn_ncalrpc_write,
+    rpcrt4_conn_ncalrpc_close,
+    rpcrt4_conn_ncalrpc_close_read,
+    rpcrt4_conn_ncalrpc_cancel_call,
     rpcrt4_ncalrpc_np_is_server_listening,
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncalrpc_get_top_of_tower,
@@ -1584,6 +1584,28 @@ void __cdecl s_authinfo_test(unsigned int protseq, int secure)
     }
 }
 
+static void
+large_transfer_tests(void)
+{
+  /* bigger than the ncalrpc shared memory rings, so the data wraps several times */
+  static const int n = 100000;
+  int *x, i, expected = 0;
+
+  x = HeapAlloc(GetProcessHeap(), 0, n * sizeof(*x));
+  for (i = 0; i < n; i++)
+  {
+    x[i] = i % 7;
+    expected += x[i];
+  }
+  /* repeat to leave the rings at a different offset every time */
+  for (i = 0; i < 3; i++)
+  {
+    ok(sum_conf_array(x, n) == expected, "RPC sum_conf_array\n");
+    ok(sum_conf_array(x, 3) == 3, "RPC sum_conf_array\n");
+  }
+  HeapFree(GetProcessHeap(), 0, x);
+}
+
 static void
 run_tests(void)
 {
@@ -1674,6 +1696,7 @@ client(const char *test)
     ok(RPC_S_OK == RpcBindingFromStringBindingA(binding, &IServer_IfHandle), "RpcBindingFromStringBinding\n");
 
     run_tests(); /* can cause RPC_X_BAD_STUB_DATA exception */
+    large_transfer_tests();
     authinfo_test(RPC_PROTSEQ_LRPC, 0);
     test_is_server_listening(IServer_IfHandle, RPC_S_OK);
 
@@ -30,6 +30,12 @@
 
 #include "tomcrypt.h"
 
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)) && \
+    (defined(__i386__) || defined(__x86_64__))
+#define USE_AES_NI
+#include <immintrin.h>
+#endif
+
 static const ulong32 TE0[256] = {
     0xc66363a5UL, 0xf87c7c84UL, 0xee777799UL, 0xf67b7b8dUL,
     0xfff2f20dUL, 0xd66b6bbdUL, 0xde6f6fb1UL, 0x91c5c554UL,
@@ -1061,11 +1067,93 @@ int aes_setup(const unsigned char *key, int keylen, int rounds, aes_key *skey)
     return CRYPT_OK;
 }
 
+#ifdef USE_AES_NI
+
+/* Calls cpuid with an eax of 'ax' and returns the 16 bytes in *p
+ * We are compiled with -fPIC, so we can't clobber ebx.
+ */
+static inline void do_cpuid(unsigned int ax, unsigned int *p)
+{
+#ifdef __i386__
+    __asm__("pushl %%ebx\n\t"
+            "cpuid\n\t"
+            "movl %%ebx, %%esi\n\t"
+            "popl %%ebx"
+            : "=a" (p[0]), "=S" (p[1]), "=c" (p[2]), "=d" (p[3])
+            : "0" (ax));
+#else
+    __asm__("push %%rbx\n\t"
+            "cpuid\n\t"
+            "movq %%rbx, %%rsi\n\t"
+            "pop %%rbx"
+            : "=a" (p[0]), "=S" (p[1]), "=c" (p[2]), "=d" (p[3])
+            : "0" (ax));
+#endif
+}
+
+static int have_aes_ni(void)
+{
+    static int supported = -1;
+    unsigned int regs[4];
+
+    if (supported == -1)
+    {
+        do_cpuid(1, regs);
+        /* AES and SSSE3 */
+        supported = (regs[2] & (1 << 25)) && (regs[2] & (1 << 9));
+    }
+    return supported;
+}
+
+/* The round keys are stored as big endian words, turn them back into bytes. */
+#define AESNI_ROUND_KEY(rk) _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(rk)), \
+    _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3))
+
+static void __attribute__((target("aes,ssse3"))) aesni_ecb_encrypt(const unsigned char *pt,
+                                                                   unsigned char *ct, aes_key *skey)
+{
+    const ulong32 *rk = skey->eK;
+    __m128i state;
+    int r;
+
+    state = _mm_xor_si128(_mm_loadu_si128((const __m128i *)pt), AESNI_ROUND_KEY(rk));
+    for (r = 1; r < skey->Nr; r++)
+        state = _mm_aesenc_si128(state, AESNI_ROUND_KEY(rk + 4 * r));
+    state = _mm_aesenclast_si128(state, AESNI_ROUND_KEY(rk + 4 * r));
+    _mm_storeu_si128((__m128i *)ct, state);
+}
+
+/* The decryption key schedule already has the inverse MixColumns applied to
+ * the middle round keys, which is the form expected by aesdec. */
+static void __attribute__((target("aes,ssse3"))) aesni_ecb_decrypt(const unsigned char *ct,
+                                                                   unsigned char *pt, aes_key *skey)
+{
+    const ulong32 *rk = skey->dK;
+    __m128i state;
+    int r;
+
+    state = _mm_xor_si128(_mm_loadu_si128((const __m128i *)ct), AESNI_ROUND_KEY(rk));
+    for (r = 1; r < skey->Nr; r++)
+        state = _mm_aesdec_si128(state, AESNI_ROUND_KEY(rk + 4 * r));
+    state = _mm_aesdeclast_si128(state, AESNI_ROUND_KEY(rk + 4 * r));
+    _mm_storeu_si128((__m128i *)pt, state);
+}
+
+#endif  /* USE_AES_NI */
+
 void aes_ecb_encrypt(const unsigned char *pt, unsigned char *ct, aes_key *skey)
 {
     ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
+#ifdef USE_AES_NI
+    if (have_aes_ni())
+    {
+        aesni_ecb_encrypt(pt, ct, skey);
+        return;
+    }
+#endif
+
     Nr = skey->Nr;
     rk = skey->eK;
 
@@ -1167,6 +1255,14 @@ void aes_ecb_decrypt(const unsigned char *ct, unsigned char *pt, aes_key *skey)
     ulong32 s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
+#ifdef USE_AES_NI
+    if (have_aes_ni())
+    {
+        aesni_ecb_decrypt(ct, pt, skey);
+        return;
+    }
+#endif
+
     Nr = skey->Nr;
     rk = skey->dK;
 
@@ -22,6 +22,7 @@
 #include "wine/port.h"
 
 #include <stdarg.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #ifdef HAVE_DIRENT_H
 # include <dirent.h>
@@ -32,6 +33,9 @@
 #ifdef HAVE_UNISTD_H
 # include <unistd.h>
 #endif
+#ifdef HAVE_SYS_IOCTL_H
+# include <sys/ioctl.h>
+#endif
 
 #define COBJMACROS
 #define ATL_INITGUID
@@ -51,6 +55,10 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(setupapi);
 
+#if defined(__linux__) && defined(_IOW) && !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
 static const char fakedll_signature[] = "Wine placeholder DLL";
 
 static const unsigned int file_alignment = 512;
@@ -64,6 +72,15 @@ static unsigned int handled_total;
 static char **handled_dlls;
 static IRegistrar *registrar;
 
+/* how fake dlls are deployed, set through the WINEFAKEDLLS environment variable */
+enum fake_dll_mode
+{
+    FAKE_DLL_COPY,      /* write a copy of the file (default) */
+    FAKE_DLL_REFLINK,   /* clone the source file if the filesystem supports it */
+    FAKE_DLL_HARDLINK   /* clone or hard link the source file if it's read-only */
+};
+static int fake_dll_mode = -1;
+
 struct dll_info
 {
     HANDLE            handle;
@@ -390,12 +407,12 @@ static inline char *prepend( char *buffer, const char *str, size_t len )
     return memcpy( buffer - len, str, len );
 }
 
-/* try to load a pre-compiled fake dll */
-static void *load_fake_dll( const WCHAR *name, SIZE_T *size )
+/* try to load a pre-compiled fake dll, optionally returning the name of the file it was read from */
+static void *load_fake_dll( const WCHAR *name, SIZE_T *size, char **filename )
 {
     const char *build_dir = wine_get_build_dir();
     const char *path;
-    char *file, *ptr;
+    char *file, *ptr = NULL;
     void *data = NULL;
     unsigned int i, pos, len, namelen, maxlen = 0;
     WCHAR *p;
@@ -447,6 +464,8 @@ static void *load_fake_dll( const WCHAR *name, SIZE_T *size )
     }
 
 done:
+    if (res == 1 && filename && (*filename = HeapAlloc( GetProcessHeap(), 0, strlen(ptr) + 1 )))
+        strcpy( *filename, ptr );
     HeapFree( GetProcessHeap(), 0, file );
     if (res == 1) return data;
     return NULL;
@@ -459,25 +478,94 @@ static HANDLE create_dest_file( const WCHAR *name )
     HANDLE h = CreateFileW( name, GENERIC_READ|GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL );
     if (h != INVALID_HANDLE_VALUE)
     {
+        BY_HANDLE_FILE_INFORMATION info;
+
         if (!is_fake_dll( h ))
         {
             TRACE( "%s is not a fake dll, not overwriting it\n", debugstr_w(name) );
             CloseHandle( h );
             return 0;
         }
-        /* truncate the file */
-        SetFilePointer( h, 0, NULL, FILE_BEGIN );
-        SetEndOfFile( h );
+        if (!GetFileInformationByHandle( h, &info ) || info.nNumberOfLinks <= 1)
+        {
+            /* truncate the file */
+            SetFilePointer( h, 0, NULL, FILE_BEGIN );
+            SetEndOfFile( h );
+            return h;
+        }
+        /* the file is a hard link to the installed fake dll, replace it instead of writing to it */
+        CloseHandle( h );
+        DeleteFileW( name );
     }
-    else
+    else if (GetLastError() == ERROR_PATH_NOT_FOUND) create_directories( name );
+
+    h = CreateFileW( name, GENERIC_WRITE, 0, NULL, CREATE_NEW, 0, NULL );
+    if (h == INVALID_HANDLE_VALUE)
+        ERR( "failed to create %s (error=%u)\n", debugstr_w(name), GetLastError() );
+    return h;
+}
+
+static int get_fake_dll_mode(void)
+{
+    if (fake_dll_mode == -1)
     {
-        if (GetLastError() == ERROR_PATH_NOT_FOUND) create_directories( name );
+        const char *str = getenv( "WINEFAKEDLLS" );
 
-        h = CreateFileW( name, GENERIC_WRITE, 0, NULL, CREATE_NEW, 0, NULL );
-        if (h == INVALID_HANDLE_VALUE)
-            ERR( "failed to create %s (error=%u)\n", debugstr_w(name), GetLastError() );
+        if (str && !strcmp( str, "hardlink" )) fake_dll_mode = FAKE_DLL_HARDLINK;
+        else if (str && !strcmp( str, "reflink" )) fake_dll_mode = FAKE_DLL_REFLINK;
+        else fake_dll_mode = FAKE_DLL_COPY;
     }
-    return h;
+    return fake_dll_mode;
+}
+
+/* try to create the fake dll destination as a clone or a hard link of the source file */
+/* return FALSE if the file has to be written normally */
+static BOOL link_fake_dll( const WCHAR *name, const char *source )
+{
+    HANDLE h;
+    char *unix_name;
+    BOOL ret = FALSE;
+#ifdef FICLONE
+    int src, dst;
+#endif
+
+    if (get_fake_dll_mode() == FAKE_DLL_COPY) return FALSE;
+
+    /* an existing fake dll has to be removed first, it may be a link itself */
+    h = CreateFileW( name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL );
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        BOOL fake = is_fake_dll( h );
+
+        CloseHandle( h );
+        if (!fake || !DeleteFileW( name )) return FALSE;
+    }
+    else if (GetLastError() == ERROR_PATH_NOT_FOUND) create_directories( name );
+
+    if (!(unix_name = wine_get_unix_file_name( name ))) return FALSE;
+
+#ifdef FICLONE
+    if ((src = open( source, O_RDONLY )) != -1)
+    {
+        if ((dst = open( unix_name, O_WRONLY | O_CREAT | O_EXCL, 0666 )) != -1)
+        {
+            ret = !ioctl( dst, FICLONE, src );
+            close( dst );
+            if (!ret) unlink( unix_name );
+        }
+        close( src );
+    }
+    if (ret) TRACE( "%s -> %s (reflink)\n", debugstr_a(source), debugstr_w(name) );
+#endif
+    /* a hard link shares the inode with the installation, so only use it
+     * if the source can't be modified through it */
+    if (!ret && get_fake_dll_mode() == FAKE_DLL_HARDLINK && access( source, W_OK ))
+    {
+        ret = !link( source, unix_name );
+        if (ret) TRACE( "%s -> %s (hardlink)\n", debugstr_a(source), debugstr_w(name) );
+    }
+    HeapFree( GetProcessHeap(), 0, unix_name );
+    return ret;
 }
 
 /* XML parsing code copied from ntdll */
@@ -859,7 +947,11 @@ static void install_fake_dll( WCHAR *dest, char *file, const char *ext )
     dll_name_AtoW( destname, name, end - name );
     if (!add_handled_dll( destname )) ret = -1;
 
-    if (ret != -1)
+    if (ret != -1 && link_fake_dll( dest, file ))
+    {
+        register_fake_dll( dest, data, size );
+    }
+    else if (ret != -1)
     {
         HANDLE h = create_dest_file( dest );
 
@@ -956,7 +1048,8 @@ BOOL create_fake_dll( const WCHAR *name, const WCHAR *source )
     BOOL ret;
     SIZE_T size;
     const WCHAR *filename;
-    void *buffer;
+    void *buffer = NULL;
+    char *source_file = NULL;
 
     if (!(filename = strrchrW( name, '\\' ))) filename = name;
     else filename++;
@@ -971,6 +1064,18 @@ BOOL create_fake_dll( const WCHAR *name, const WCHAR *source )
 
     add_handled_dll( filename );
 
+    if (source[0] != '-' || source[1])
+    {
+        buffer = load_fake_dll( source, &size, &source_file );
+        if (buffer && source_file && link_fake_dll( name, source_file ))
+        {
+            HeapFree( GetProcessHeap(), 0, source_file );
+            register_fake_dll( name, buffer, size );
+            return TRUE;
+        }
+        HeapFree( GetProcessHeap(), 0, source_file );
+    }
+
     if (!(h = create_dest_file( name ))) return TRUE;  /* not a fake dll */
     if (h == INVALID_HANDLE_VALUE) return FALSE;
 
@@ -980,7 +1085,7 @@ BOOL create_fake_dll( const WCHAR *name, const WCHAR *source )
         TRACE( "deleting %s\n", debugstr_w(name) );
         ret = FALSE;
     }
-    else if ((buffer = load_fake_dll( source, &size )))
+    else if (buffer)
     {
         DWORD written;
 
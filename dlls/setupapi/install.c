@@ -37,6 +37,7 @@
 #include "setupapi.h"
 #include "setupapi_private.h"
 #include "wine/unicode.h"
+#include "wine/list.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(setupapi);
@@ -66,6 +67,26 @@ struct register_dll_info
     int                 modules_size;
     int                 modules_count;
     HMODULE            *modules;
+    CRITICAL_SECTION   *lock;       /* protects modules when registering in parallel */
+};
+
+/* pending entry of a RegisterDlls section, for parallel registration */
+struct register_dll_work
+{
+    struct list entry;
+    WCHAR      *path;
+    WCHAR      *args;
+    INT         flags;
+    INT         timeout;
+};
+
+/* entries of a RegisterDlls section shared between registration threads */
+struct register_dll_queue
+{
+    struct register_dll_info *info;
+    CRITICAL_SECTION          cs;
+    struct list               work;
+    unsigned int              count;
 };
 
 typedef BOOL (*iterate_fields_func)( HINF hinf, PCWSTR field, void *arg );
@@ -626,6 +647,7 @@ static BOOL do_register_dll( struct register_dll_info *info, const WCHAR *path,
 done:
     if (module)
     {
+        if (info->lock) EnterCriticalSection( info->lock );
         if (info->modules_count >= info->modules_size)
         {
             int new_size = max( 32, info->modules_size * 2 );
@@ -640,6 +662,7 @@ done:
         }
         if (info->modules_count < info->modules_size) info->modules[info->modules_count++] = module;
         else FreeLibrary( module );
+        if (info->lock) LeaveCriticalSection( info->lock );
     }
     if (info->callback) info->callback( info->callback_context, SPFILENOTIFY_ENDREGISTRATION,
                                         (UINT_PTR)&status, !info->unregister );
@@ -647,18 +670,117 @@ done:
 }
 
 
+/***********************************************************************
+ *            use_parallel_registration
+ *
+ * Check whether the entries of a RegisterDlls section can be registered in parallel.
+ * This is only done on request through the WINESETUPAPIPARALLEL environment variable,
+ * and never when a callback expects the notifications in order.
+ */
+static BOOL use_parallel_registration( const struct register_dll_info *info )
+{
+    static const WCHAR parallelW[] = {'W','I','N','E','S','E','T','U','P','A','P','I',
+                                      'P','A','R','A','L','L','E','L',0};
+    static int enabled = -1;
+    WCHAR buffer[16];
+
+    if (info->callback) return FALSE;
+    if (enabled == -1)
+    {
+        enabled = GetEnvironmentVariableW( parallelW, buffer, sizeof(buffer)/sizeof(WCHAR) ) &&
+                  buffer[0] && buffer[0] != '0';
+        if (enabled) TRACE( "registering dlls in parallel\n" );
+    }
+    return enabled;
+}
+
+
+/***********************************************************************
+ *            register_dll_thread
+ *
+ * Worker thread for parallel registration, processes entries until the queue is empty.
+ */
+static DWORD WINAPI register_dll_thread( void *arg )
+{
+    struct register_dll_queue *queue = arg;
+    struct register_dll_work *work;
+    struct list *ptr;
+
+    for (;;)
+    {
+        EnterCriticalSection( &queue->cs );
+        if ((ptr = list_head( &queue->work ))) list_remove( ptr );
+        LeaveCriticalSection( &queue->cs );
+        if (!ptr) break;
+
+        work = LIST_ENTRY( ptr, struct register_dll_work, entry );
+        do_register_dll( queue->info, work->path, work->flags, work->timeout, work->args );
+        HeapFree( GetProcessHeap(), 0, work->path );
+        HeapFree( GetProcessHeap(), 0, work->args );
+        HeapFree( GetProcessHeap(), 0, work );
+    }
+    return 0;
+}
+
+
+/***********************************************************************
+ *            run_register_dll_queue
+ *
+ * Register all the queued entries of a section, using up to one thread per cpu.
+ * The calling thread takes part in the work, and returns once all entries are done.
+ */
+static void run_register_dll_queue( struct register_dll_queue *queue )
+{
+    HANDLE threads[16];
+    SYSTEM_INFO si;
+    unsigned int i, max_threads, nb_threads = 0;
+
+    GetSystemInfo( &si );
+    max_threads = min( min( si.dwNumberOfProcessors, queue->count ), sizeof(threads)/sizeof(threads[0]) + 1 );
+    TRACE( "registering %u entries with %u threads\n", queue->count, max_threads );
+
+    queue->info->lock = &queue->cs;
+    for (i = 1; i < max_threads; i++)
+    {
+        if (!(threads[nb_threads] = CreateThread( NULL, 0, register_dll_thread, queue, 0, NULL )))
+        {
+            WARN( "failed to create registration thread, error %u\n", GetLastError() );
+            break;
+        }
+        nb_threads++;
+    }
+    register_dll_thread( queue );
+    if (nb_threads) WaitForMultipleObjects( nb_threads, threads, TRUE, INFINITE );
+    for (i = 0; i < nb_threads; i++) CloseHandle( threads[i] );
+    queue->info->lock = NULL;
+}
+
+
 /***********************************************************************
  *            register_dlls_callback
  *
  * Called once for each RegisterDlls entry in a given section.
+ * In parallel mode the lines of a section are registered concurrently, but
+ * sections are still processed one after another, so entries that others
+ * depend on have to be listed in an earlier section.
  */
 static BOOL register_dlls_callback( HINF hinf, PCWSTR field, void *arg )
 {
     struct register_dll_info *info = arg;
+    struct register_dll_queue queue;
     INFCONTEXT context;
-    BOOL ret = TRUE;
+    BOOL ret = TRUE, parallel = use_parallel_registration( info );
     BOOL ok = SetupFindFirstLineW( hinf, field, NULL, &context );
 
+    if (parallel)
+    {
+        queue.info = info;
+        queue.count = 0;
+        list_init( &queue.work );
+        InitializeCriticalSection( &queue.cs );
+        queue.cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": register_dll_queue.cs");
+    }
+
     for (; ok; ok = SetupFindNextLine( &context, &context ))
     {
         WCHAR *path, *args, *p;
@@ -689,12 +811,33 @@ static BOOL register_dlls_callback( HINF hinf, PCWSTR field, void *arg )
         if (SetupGetStringFieldW( &context, 6, buffer, sizeof(buffer)/sizeof(WCHAR), NULL ))
             args = buffer;
 
+        if (parallel)
+        {
+            struct register_dll_work *work;
+
+            if (!(work = HeapAlloc( GetProcessHeap(), 0, sizeof(*work) ))) goto done;
+            work->path    = path;
+            work->args    = args ? strdupW( args ) : NULL;
+            work->flags   = flags;
+            work->timeout = timeout;
+            list_add_tail( &queue.work, &work->entry );
+            queue.count++;
+            continue;
+        }
+
         ret = do_register_dll( info, path, flags, timeout, args );
 
     done:
         HeapFree( GetProcessHeap(), 0, path );
         if (!ret) break;
     }
+
+    if (parallel)
+    {
+        if (queue.count) run_register_dll_queue( &queue );
+        queue.cs.DebugInfo->Spare[0] = 0;
+        DeleteCriticalSection( &queue.cs );
+    }
     return ret;
 }
 
@@ -1123,6 +1266,7 @@ BOOL WINAPI SetupInstallFromInfSectionW( HWND owner, HINF hinf, PCWSTR section,
         info.modules_size  = 0;
         info.modules_count = 0;
         info.modules       = NULL;
+        info.lock          = NULL;
         if (flags & SPINST_REGISTERCALLBACKAWARE)
         {
             info.callback         = callback;
@@ -1148,6 +1292,7 @@ BOOL WINAPI SetupInstallFromInfSectionW( HWND owner, HINF hinf, PCWSTR section,
         info.modules_size  = 0;
         info.modules_count = 0;
         info.modules       = NULL;
+        info.lock          = NULL;
         if (flags & SPINST_REGISTERCALLBACKAWARE)
         {
             info.callback         = callback;
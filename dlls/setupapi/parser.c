@@ -39,6 +39,7 @@
 #include "setupapi_private.h"
 
 #include "wine/unicode.h"
+#include "wine/list.h"
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(setupapi);
@@ -61,6 +62,7 @@ struct line
     int first_field;           /* index of first field in field array */
     int nb_fields;             /* number of fields in line */
     int key_field;             /* index of field for key or -1 if no key */
+    int next_match;            /* index of next line in section with the same key, or -1 */
 };
 
 struct section
@@ -71,6 +73,15 @@ struct section
     struct line  lines[16];    /* lines information (grown dynamically, 16 is initial size) */
 };
 
+struct key_slot
+{
+    unsigned int hash;         /* hash of section index and key */
+    int          section;      /* section index, -1 if slot is free */
+    int          line;         /* first line with that key in the section */
+};
+
+struct inf_cache_entry;
+
 struct inf_file
 {
     struct inf_file *next;            /* next appended file */
@@ -84,8 +95,39 @@ struct inf_file
     struct field    *fields;
     int              strings_section; /* index of [Strings] section or -1 if none */
     WCHAR           *filename;        /* filename of the INF */
+    unsigned int     section_hash_size; /* size of the section hash table (power of 2) */
+    int             *section_hash;    /* section indexes hashed by name, -1 if slot is free */
+    unsigned int     key_hash_size;   /* size of the key hash table (power of 2) */
+    struct key_slot *key_hash;        /* first line of each key, hashed by section and key */
+    struct inf_cache_entry *cache;    /* cache entry holding the parsed data, if shared */
+};
+
+/* Parsed files are cached, so that opening the same file again doesn't parse it
+ * again. The parsed data is read-only and shared between the handles opened on
+ * the file; a few unused entries are kept around in case it's opened again. */
+#define MAX_UNUSED_CACHE_ENTRIES 8
+
+struct inf_cache_entry
+{
+    struct list      entry;
+    LONG             refcount;        /* number of handles using the entry */
+    WCHAR           *path;            /* full path of the file */
+    DWORD            size;            /* size of the file */
+    DWORD            crc;             /* checksum of the file contents */
+    struct inf_file *file;            /* parsed data */
 };
 
+static struct list inf_cache = LIST_INIT( inf_cache );
+
+static CRITICAL_SECTION inf_cache_cs;
+static CRITICAL_SECTION_DEBUG inf_cache_cs_debug =
+{
+    0, 0, &inf_cache_cs,
+    { &inf_cache_cs_debug.ProcessLocksList, &inf_cache_cs_debug.ProcessLocksList },
+    0, 0, { (DWORD_PTR)(__FILE__ ": inf_cache_cs") }
+};
+static CRITICAL_SECTION inf_cache_cs = { &inf_cache_cs_debug, -1, 0, 0, 0, 0 };
+
 /* parser definitions */
 
 enum parser_state
@@ -184,32 +226,155 @@ static const WCHAR *get_inf_dir( const struct inf_file *file, unsigned int *len
 }
 
 
+/* case-insensitive hash of a section or key name (as counted string) */
+static unsigned int hash_name( const WCHAR *name, unsigned int len )
+{
+    unsigned int hash = 0;
+
+    while (len--) hash = hash * 31 + tolowerW( *name++ );
+    return hash;
+}
+
+
 /* find a section by name */
 static int find_section( const struct inf_file *file, const WCHAR *name )
 {
-    unsigned int i;
+    unsigned int pos, mask = file->section_hash_size - 1;
+    int index;
 
-    for (i = 0; i < file->nb_sections; i++)
-        if (!strcmpiW( name, file->sections[i]->name )) return i;
+    if (!file->section_hash_size) return -1;
+    for (pos = hash_name( name, strlenW(name) ) & mask; (index = file->section_hash[pos]) != -1;
+         pos = (pos + 1) & mask)
+        if (!strcmpiW( name, file->sections[index]->name )) return index;
     return -1;
 }
 
 
+/* add the last section to the section hash table, growing it if necessary */
+static BOOL hash_new_section( struct inf_file *file )
+{
+    unsigned int i, pos, start, mask;
+
+    if (2 * file->nb_sections > file->section_hash_size)
+    {
+        unsigned int size = file->section_hash_size ? 2 * file->section_hash_size : 32;
+        int *hash = HeapAlloc( GetProcessHeap(), 0, size * sizeof(*hash) );
+
+        if (!hash) return FALSE;
+        memset( hash, 0xff, size * sizeof(*hash) );
+        HeapFree( GetProcessHeap(), 0, file->section_hash );
+        file->section_hash = hash;
+        file->section_hash_size = size;
+        start = 0;
+    }
+    else start = file->nb_sections - 1;
+
+    mask = file->section_hash_size - 1;
+    for (i = start; i < file->nb_sections; i++)
+    {
+        const WCHAR *name = file->sections[i]->name;
+
+        pos = hash_name( name, strlenW(name) ) & mask;
+        while (file->section_hash[pos] != -1) pos = (pos + 1) & mask;
+        file->section_hash[pos] = i;
+    }
+    return TRUE;
+}
+
+
+/* hash of a key in a given section */
+static inline unsigned int hash_key( int section_index, const WCHAR *key, unsigned int len )
+{
+    return hash_name( key, len ) ^ (section_index * 0x9e3779b9);
+}
+
+
+/* find the hash slot of a key in a section, or the free slot where it would go */
+static struct key_slot *find_key_slot( const struct inf_file *file, int section_index,
+                                       const WCHAR *key, unsigned int len )
+{
+    unsigned int pos, mask = file->key_hash_size - 1;
+    unsigned int hash = hash_key( section_index, key, len );
+    struct key_slot *slot;
+    const WCHAR *text;
+
+    for (pos = hash & mask; ; pos = (pos + 1) & mask)
+    {
+        slot = &file->key_hash[pos];
+        if (slot->section == -1) return slot;
+        if (slot->hash != hash || slot->section != section_index) continue;
+        text = file->fields[file->sections[section_index]->lines[slot->line].key_field].text;
+        if (!strncmpiW( key, text, len ) && !text[len]) return slot;
+    }
+}
+
+
+/* build the hash table of the line keys, once the file is parsed */
+static BOOL hash_line_keys( struct inf_file *file )
+{
+    unsigned int i, j, count = 0, size = 16;
+
+    for (i = 0; i < file->nb_sections; i++)
+        for (j = 0; j < file->sections[i]->nb_lines; j++)
+            if (file->sections[i]->lines[j].key_field != -1) count++;
+
+    while (size < 2 * count) size *= 2;
+    if (!(file->key_hash = HeapAlloc( GetProcessHeap(), 0, size * sizeof(*file->key_hash) ))) return FALSE;
+    file->key_hash_size = size;
+    for (i = 0; i < size; i++) file->key_hash[i].section = -1;
+
+    /* insert the lines in reverse order to chain each key's lines in file order */
+    for (i = 0; i < file->nb_sections; i++)
+    {
+        struct section *section = file->sections[i];
+
+        for (j = section->nb_lines; j > 0; j--)
+        {
+            struct line *line = &section->lines[j - 1];
+            const WCHAR *key;
+            struct key_slot *slot;
+
+            if (line->key_field == -1) continue;
+            key = file->fields[line->key_field].text;
+            slot = find_key_slot( file, i, key, strlenW(key) );
+            if (slot->section == -1)
+            {
+                slot->hash    = hash_key( i, key, strlenW(key) );
+                slot->section = i;
+            }
+            else line->next_match = slot->line;
+            slot->line = j - 1;
+        }
+    }
+    return TRUE;
+}
+
+
+/* find the first line of a section with the specified key, starting from a given line */
+static int find_key_line( const struct inf_file *file, int section_index, const WCHAR *key,
+                          unsigned int len, unsigned int start )
+{
+    const struct section *section = file->sections[section_index];
+    const struct key_slot *slot;
+    int line;
+
+    if (!file->key_hash_size) return -1;
+    slot = find_key_slot( file, section_index, key, len );
+    if (slot->section == -1) return -1;
+    line = slot->line;
+    while (line != -1 && (unsigned int)line < start) line = section->lines[line].next_match;
+    return line;
+}
+
+
 /* find a line by name */
 static struct line *find_line( struct inf_file *file, int section_index, const WCHAR *name )
 {
-    struct section *section;
-    struct line *line;
-    unsigned int i;
+    int line;
 
     if (section_index < 0 || section_index >= file->nb_sections) return NULL;
-    section = file->sections[section_index];
-    for (i = 0, line = section->lines; i < section->nb_lines; i++, line++)
-    {
-        if (line->key_field == -1) continue;
-        if (!strcmpiW( name, file->fields[line->key_field].text )) return line;
-    }
-    return NULL;
+    if ((line = find_key_line( file, section_index, name, strlenW(name), 0 )) == -1) return NULL;
+    return &file->sections[section_index]->lines[line];
 }
 
 
@@ -227,8 +392,14 @@ static int add_section( struct inf_file *file, const WCHAR *name )
     section->name        = name;
     section->nb_lines    = 0;
     section->alloc_lines = sizeof(section->lines)/sizeof(section->lines[0]);
-    file->sections[file->nb_sections] = section;
-    return file->nb_sections++;
+    file->sections[file->nb_sections++] = section;
+    if (!hash_new_section( file ))
+    {
+        file->nb_sections--;
+        HeapFree( GetProcessHeap(), 0, section );
+        return -1;
+    }
+    return file->nb_sections - 1;
 }
 
 
@@ -252,6 +423,7 @@ static struct line *add_line( struct inf_file *file, int section_index )
     line->first_field = file->nb_fields;
     line->nb_fields   = 0;
     line->key_field   = -1;
+    line->next_match  = -1;
     return line;
 }
 
@@ -322,11 +494,9 @@ static const WCHAR *get_string_subst( const struct inf_file *file, const WCHAR *
 {
     static const WCHAR percent = '%';
 
-    struct section *strings_section;
     struct line *line;
     struct field *field;
-    unsigned int i;
-    int dirid;
+    int i, dirid;
     WCHAR *dirid_str, *end;
     const WCHAR *ret = NULL;
 
@@ -336,14 +506,9 @@ static const WCHAR *get_string_subst( const struct inf_file *file, const WCHAR *
         return &percent;
     }
     if (file->strings_section == -1) goto not_found;
-    strings_section = file->sections[file->strings_section];
-    for (i = 0, line = strings_section->lines; i < strings_section->nb_lines; i++, line++)
-    {
-        if (line->key_field == -1) continue;
-        if (strncmpiW( str, file->fields[line->key_field].text, *len )) continue;
-        if (!file->fields[line->key_field].text[*len]) break;
-    }
-    if (i == strings_section->nb_lines || !line->nb_fields) goto not_found;
+    if ((i = find_key_line( file, file->strings_section, str, *len, 0 )) == -1) goto not_found;
+    line = &file->sections[file->strings_section]->lines[i];
+    if (!line->nb_fields) goto not_found;
     field = &file->fields[line->first_field];
     *len = strlenW( field->text );
     return field->text;
@@ -860,19 +1025,122 @@ static const WCHAR *comment_state( struct parser *parser, const WCHAR *pos )
 }
 
 
+static void release_cache_entry( struct inf_cache_entry *cache );
+
 static void free_inf_file( struct inf_file *file )
 {
     unsigned int i;
 
+    if (file->cache)  /* the parsed data belongs to the cache */
+    {
+        release_cache_entry( file->cache );
+        HeapFree( GetProcessHeap(), 0, file->filename );
+        HeapFree( GetProcessHeap(), 0, file );
+        return;
+    }
     for (i = 0; i < file->nb_sections; i++) HeapFree( GetProcessHeap(), 0, file->sections[i] );
     HeapFree( GetProcessHeap(), 0, file->filename );
     HeapFree( GetProcessHeap(), 0, file->sections );
     HeapFree( GetProcessHeap(), 0, file->fields );
     HeapFree( GetProcessHeap(), 0, file->strings );
+    HeapFree( GetProcessHeap(), 0, file->section_hash );
+    HeapFree( GetProcessHeap(), 0, file->key_hash );
     HeapFree( GetProcessHeap(), 0, file );
 }
 
 
+/* create a new handle sharing the parsed data of a cache entry; inf_cache_cs must be held */
+static struct inf_file *share_cache_entry( struct inf_cache_entry *cache )
+{
+    struct inf_file *file;
+
+    if (!(file = HeapAlloc( GetProcessHeap(), 0, sizeof(*file) ))) return NULL;
+    *file = *cache->file;
+    file->cache = cache;
+    cache->refcount++;
+    return file;
+}
+
+
+/* release a handle reference to a cache entry, and free the unused entries beyond the limit */
+static void release_cache_entry( struct inf_cache_entry *cache )
+{
+    struct inf_cache_entry *entry, *next;
+    unsigned int unused = 0;
+
+    EnterCriticalSection( &inf_cache_cs );
+    if (!--cache->refcount)
+    {
+        LIST_FOR_EACH_ENTRY_SAFE( entry, next, &inf_cache, struct inf_cache_entry, entry )
+        {
+            if (entry->refcount || ++unused <= MAX_UNUSED_CACHE_ENTRIES) continue;
+            TRACE( "freeing %s\n", debugstr_w(entry->path) );
+            list_remove( &entry->entry );
+            free_inf_file( entry->file );
+            HeapFree( GetProcessHeap(), 0, entry->path );
+            HeapFree( GetProcessHeap(), 0, entry );
+        }
+    }
+    LeaveCriticalSection( &inf_cache_cs );
+}
+
+
+/* open a new handle on a cached file with the same contents */
+static struct inf_file *get_cached_inf_file( const WCHAR *path, DWORD size, DWORD crc )
+{
+    struct inf_cache_entry *cache;
+    struct inf_file *file = NULL;
+
+    EnterCriticalSection( &inf_cache_cs );
+    LIST_FOR_EACH_ENTRY( cache, &inf_cache, struct inf_cache_entry, entry )
+    {
+        if (cache->size != size || cache->crc != crc || strcmpiW( cache->path, path )) continue;
+        if ((file = share_cache_entry( cache )))
+        {
+            /* move it to the front to keep the most recently used entries */
+            list_remove( &cache->entry );
+            list_add_head( &inf_cache, &cache->entry );
+            TRACE( "using cached %s\n", debugstr_w(path) );
+        }
+        break;
+    }
+    LeaveCriticalSection( &inf_cache_cs );
+    return file;
+}
+
+
+/* add a newly parsed file to the cache, and return a handle sharing it */
+static struct inf_file *cache_inf_file( const WCHAR *path, DWORD size, DWORD crc, struct inf_file *file )
+{
+    struct inf_cache_entry *cache;
+    struct inf_file *ret = NULL;
+
+    if (!(cache = HeapAlloc( GetProcessHeap(), 0, sizeof(*cache) ))) return file;
+    if (!(cache->path = HeapAlloc( GetProcessHeap(), 0, (strlenW(path) + 1) * sizeof(WCHAR) )))
+    {
+        HeapFree( GetProcessHeap(), 0, cache );
+        return file;
+    }
+    strcpyW( cache->path, path );
+    cache->size     = size;
+    cache->crc      = crc;
+    cache->file     = file;
+    cache->refcount = 0;
+
+    EnterCriticalSection( &inf_cache_cs );
+    if ((ret = share_cache_entry( cache ))) list_add_head( &inf_cache, &cache->entry );
+    LeaveCriticalSection( &inf_cache_cs );
+
+    if (!ret)
+    {
+        HeapFree( GetProcessHeap(), 0, cache->path );
+        HeapFree( GetProcessHeap(), 0, cache );
+        return file;
+    }
+    return ret;
+}
+
+
 /* parse a complete buffer */
 static DWORD parse_buffer( struct inf_file *file, const WCHAR *buffer, const WCHAR *end,
                            UINT *error_line )
@@ -919,6 +1187,12 @@ static DWORD parse_buffer( struct inf_file *file, const WCHAR *buffer, const WCH
         return parser.error;
     }
 
+    if (!hash_line_keys( file ))
+    {
+        if (error_line) *error_line = parser.line_pos;
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+
     /* find the [strings] section */
     file->strings_section = find_section( file, Strings );
 
@@ -952,10 +1226,11 @@ static void append_inf_file( struct inf_file *parent, struct inf_file *child )
  *
  * parse an INF file.
  */
-static struct inf_file *parse_file( HANDLE handle, const WCHAR *class, DWORD style, UINT *error_line )
+static struct inf_file *parse_file( HANDLE handle, const WCHAR *path, const WCHAR *class,
+                                    DWORD style, UINT *error_line )
 {
     void *buffer;
-    DWORD err = 0;
+    DWORD crc, err = 0;
     struct inf_file *file;
 
     DWORD size = GetFileSize( handle, NULL );
@@ -967,6 +1242,9 @@ static struct inf_file *parse_file( HANDLE handle, const WCHAR *class, DWORD sty
 
     if (class) FIXME( "class %s not supported yet\n", debugstr_w(class) );
 
+    crc = RtlComputeCrc32( 0, buffer, size );
+    if ((file = get_cached_inf_file( path, size, crc ))) goto check;
+
     if (!(file = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*file) )))
     {
         err = ERROR_NOT_ENOUGH_MEMORY;
@@ -1013,8 +1291,11 @@ static struct inf_file *parse_file( HANDLE handle, const WCHAR *class, DWORD sty
             new_buff++;
         err = parse_buffer( file, new_buff, (WCHAR *)((char *)buffer + size), error_line );
     }
+    if (err) goto done;
+
+    file = cache_inf_file( path, size, crc, file );
 
-    if (!err)  /* now check signature */
+ check:  /* now check signature */
     {
         int version_index = find_section( file, Version );
         if (version_index != -1)
@@ -1172,7 +1453,7 @@ HINF WINAPI SetupOpenInfFileW( PCWSTR name, PCWSTR class, DWORD style, UINT *err
 
     if (handle != INVALID_HANDLE_VALUE)
     {
-        file = parse_file( handle, class, style, error );
+        file = parse_file( handle, path, class, style, error );
         CloseHandle( handle );
     }
     if (!file)
@@ -1559,8 +1840,7 @@ BOOL WINAPI SetupFindNextMatchLineW( PINFCONTEXT context_in, PCWSTR key,
 {
     struct inf_file *file = context_in->CurrentInf;
     struct section *section;
-    struct line *line;
-    unsigned int i;
+    int i;
 
     if (!key) return SetupFindNextLine( context_in, context_out );
 
@@ -1568,18 +1848,14 @@ BOOL WINAPI SetupFindNextMatchLineW( PINFCONTEXT context_in, PCWSTR key,
 
     section = file->sections[context_in->Section];
 
-    for (i = context_in->Line+1, line = &section->lines[i]; i < section->nb_lines; i++, line++)
+    if ((i = find_key_line( file, context_in->Section, key, strlenW(key), context_in->Line + 1 )) != -1)
     {
-        if (line->key_field == -1) continue;
-        if (!strcmpiW( key, file->fields[line->key_field].text ))
-        {
-            if (context_out != context_in) *context_out = *context_in;
-            context_out->Line = i;
-            SetLastError( 0 );
-            TRACE( "(%p,%s,%s): returning %d\n",
-                   file, debugstr_w(section->name), debugstr_w(key), i );
-            return TRUE;
-        }
+        if (context_out != context_in) *context_out = *context_in;
+        context_out->Line = i;
+        SetLastError( 0 );
+        TRACE( "(%p,%s,%s): returning %d\n",
+               file, debugstr_w(section->name), debugstr_w(key), i );
+        return TRUE;
     }
 
     /* now search the appended files */
@@ -1588,21 +1864,16 @@ BOOL WINAPI SetupFindNextMatchLineW( PINFCONTEXT context_in, PCWSTR key,
     {
         int section_index = find_section( file, section->name );
         if (section_index == -1) continue;
-        section = file->sections[section_index];
-        for (i = 0, line = section->lines; i < section->nb_lines; i++, line++)
+        if ((i = find_key_line( file, section_index, key, strlenW(key), 0 )) != -1)
         {
-            if (line->key_field == -1) continue;
-            if (!strcmpiW( key, file->fields[line->key_field].text ))
-            {
-                context_out->Inf        = context_in->Inf;
-                context_out->CurrentInf = file;
-                context_out->Section    = section_index;
-                context_out->Line       = i;
-                SetLastError( 0 );
-                TRACE( "(%p,%s,%s): returning %d/%d\n",
-                       file, debugstr_w(section->name), debugstr_w(key), section_index, i );
-                return TRUE;
-            }
+            context_out->Inf        = context_in->Inf;
+            context_out->CurrentInf = file;
+            context_out->Section    = section_index;
+            context_out->Line       = i;
+            SetLastError( 0 );
+            TRACE( "(%p,%s,%s): returning %d/%d\n",
+                   file, debugstr_w(section->name), debugstr_w(key), section_index, i );
+            return TRUE;
         }
     }
     TRACE( "(%p,%s,%s): not found\n",
@@ -502,6 +502,40 @@ static void test_close_inf_file(void)
         "Expected 0xdeadbeef, got %u\n", GetLastError());
 }
 
+static void test_reopen_modified(void)
+{
+    INFCONTEXT context;
+    UINT err_line;
+    HINF hinf, hinf2;
+    BOOL ret;
+
+    /* same size and path, only the contents differ */
+    hinf = test_file_contents( STD_HEADER "[s]\nkey=aaa\nother=1\nkey=ccc\n", &err_line );
+    ok( hinf != INVALID_HANDLE_VALUE, "open failed err %u\n", GetLastError() );
+    hinf2 = test_file_contents( STD_HEADER "[s]\nkey=bbb\nother=1\nkey=ddd\n", &err_line );
+    ok( hinf2 != INVALID_HANDLE_VALUE, "open failed err %u\n", GetLastError() );
+    if (hinf == INVALID_HANDLE_VALUE || hinf2 == INVALID_HANDLE_VALUE) return;
+
+    ret = SetupFindFirstLineA( hinf, "s", "KEY", &context );
+    ok( ret, "key not found\n" );
+    ok( !strcmp( get_string_field( &context, 1 ), "aaa" ), "got %s\n", get_string_field( &context, 1 ));
+    ret = SetupFindNextMatchLineA( &context, "key", &context );
+    ok( ret, "second key not found\n" );
+    ok( !strcmp( get_string_field( &context, 1 ), "ccc" ), "got %s\n", get_string_field( &context, 1 ));
+    ret = SetupFindNextMatchLineA( &context, "key", &context );
+    ok( !ret, "third key found\n" );
+
+    ret = SetupFindFirstLineA( hinf2, "S", "key", &context );
+    ok( ret, "key not found\n" );
+    ok( !strcmp( get_string_field( &context, 1 ), "bbb" ), "got %s\n", get_string_field( &context, 1 ));
+    ret = SetupFindNextMatchLineA( &context, "key", &context );
+    ok( ret, "second key not found\n" );
+    ok( !strcmp( get_string_field( &context, 1 ), "ddd" ), "got %s\n", get_string_field( &context, 1 ));
+
+    SetupCloseInfFile( hinf );
+    SetupCloseInfFile( hinf2 );
+}
+
 static const char *contents = "[Version]\n"
                               "Signature=\"$Windows NT$\"\n"
                               "FileVersion=5.1.1.2\n"
@@ -783,6 +817,7 @@ START_TEST(parser)
     test_enum_sections();
     test_key_names();
     test_close_inf_file();
+    test_reopen_modified();
     test_pSetupGetField();
     test_SetupGetIntField();
     test_GLE();
@@ -53,6 +53,134 @@ WINE_DEFAULT_DEBUG_CHANNEL(win);
 WINE_DECLARE_DEBUG_CHANNEL(keyboard);
 
 INT global_key_state_counter = 0;
+INT shared_requests_avoided[NB_SHARED_REQUESTS];
+
+static const window_shm_t *shared_windows;
+
+/***********************************************************************
+ *           map_shared_section
+ */
+static const void *map_shared_section( obj_handle_t handle )
+{
+    const void *ptr;
+
+    if (!handle) return NULL;
+    ptr = MapViewOfFile( wine_server_ptr_handle( handle ), FILE_MAP_READ, 0, 0, 0 );
+    CloseHandle( wine_server_ptr_handle( handle ));
+    return ptr;
+}
+
+/***********************************************************************
+ *           get_shared_state
+ *
+ * Return the thread key state info with the views of the state shared by
+ * the server, mapping them on first use. Returns NULL if not available.
+ */
+struct user_key_state_info *get_shared_state(void)
+{
+    struct user_thread_info *thread_info = get_user_thread_info();
+    struct user_key_state_info *info = thread_info->key_state;
+    obj_handle_t windows = 0, desktop = 0, queue = 0;
+    const void *ptr;
+
+    if (!info)
+    {
+        if (!(info = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*info) ))) return NULL;
+        thread_info->key_state = info;
+    }
+    if (info->desktop_shm) return info;
+    if (info->shm_failed) return NULL;
+
+    /* the handles are returned even if the request failed halfway */
+    SERVER_START_REQ( get_user_shared_memory )
+    {
+        req->queue_only = FALSE;
+        wine_server_call( req );
+        windows = reply->windows;
+        desktop = reply->desktop;
+        queue   = reply->queue;
+    }
+    SERVER_END_REQ;
+
+    if ((ptr = map_shared_section( windows )) &&
+        interlocked_cmpxchg_ptr( (void **)&shared_windows, (void *)ptr, NULL ))
+        UnmapViewOfFile( ptr );  /* another thread mapped it first */
+    if ((ptr = map_shared_section( queue )))
+    {
+        if (!info->queue_shm) info->queue_shm = ptr;
+        else UnmapViewOfFile( ptr );
+    }
+    info->desktop_shm = map_shared_section( desktop );
+
+    /* the queue section is mapped later if the thread doesn't have a queue yet */
+    if (!shared_windows || !info->desktop_shm)
+    {
+        WARN( "shared user state not available\n" );
+        info->shm_failed = TRUE;
+        return NULL;
+    }
+    return info;
+}
+
+/***********************************************************************
+ *           free_shared_state
+ */
+void free_shared_state( struct user_key_state_info *info )
+{
+    if (info->desktop_shm) UnmapViewOfFile( info->desktop_shm );
+    if (info->queue_shm) UnmapViewOfFile( info->queue_shm );
+    info->desktop_shm = NULL;
+    info->queue_shm = NULL;
+}
+
+/***********************************************************************
+ *           get_shared_windows
+ */
+const window_shm_t *get_shared_windows(void)
+{
+    if (!shared_windows) get_shared_state();
+    return shared_windows;
+}
+
+/***********************************************************************
+ *           get_shared_queue_bits
+ */
+static BOOL get_shared_queue_bits( DWORD *wake_bits, DWORD *changed_bits )
+{
+    struct user_key_state_info *info = get_shared_state();
+    const queue_shm_t *shm;
+    int seq;
+
+    if (!info) return FALSE;
+    if (!(shm = info->queue_shm))
+    {
+        obj_handle_t queue = 0;
+        NTSTATUS status;
+
+        SERVER_START_REQ( get_user_shared_memory )
+        {
+            req->queue_only = TRUE;
+            status = wine_server_call( req );
+            queue = reply->queue;
+        }
+        SERVER_END_REQ;
+
+        if (!status && !queue)
+        {
+            /* nothing can be queued for a thread without a queue */
+            *wake_bits = *changed_bits = 0;
+            return TRUE;
+        }
+        if (!(shm = info->queue_shm = map_shared_section( queue ))) return FALSE;
+    }
+    do
+    {
+        seq = shm_read_begin( &shm->seq );
+        *wake_bits    = shm->wake_bits;
+        *changed_bits = shm->changed_bits;
+    } while (shm_read_retry( &shm->seq, seq ));
+    return TRUE;
+}
 
 /***********************************************************************
  *           get_key_state
@@ -388,9 +516,9 @@ static void check_for_events( UINT flags )
  */
 SHORT WINAPI DECLSPEC_HOTPATCH GetAsyncKeyState( INT key )
 {
-    struct user_key_state_info *key_state_info = get_user_thread_info()->key_state;
+    struct user_key_state_info *key_state_info;
     INT counter = global_key_state_counter;
-    BYTE prev_key_state;
+    BYTE prev_key_state, state;
     SHORT ret;
 
     if (key < 0 || key >= 256) return 0;
@@ -399,6 +527,15 @@ SHORT WINAPI DECLSPEC_HOTPATCH GetAsyncKeyState( INT key )
 
     if ((ret = USER_Driver->pGetAsyncKeyState( key )) == -1)
     {
+        /* the server only needs to be called to reset the pressed bit */
+        if ((key_state_info = get_shared_state()) &&
+            !((state = key_state_info->desktop_shm->keystate[key]) & 0x40))
+        {
+            interlocked_xchg_add( &shared_requests_avoided[SHARED_KEY_STATE], 1 );
+            return (state & 0x80) ? 0x8000 : 0;
+        }
+        key_state_info = get_user_thread_info()->key_state;
+
         if (key_state_info &&
             !(key_state_info->state[key] & 0xc0) &&
             key_state_info->counter == counter &&
@@ -451,7 +588,7 @@ SHORT WINAPI DECLSPEC_HOTPATCH GetAsyncKeyState( INT key )
  */
 DWORD WINAPI GetQueueStatus( UINT flags )
 {
-    DWORD ret;
+    DWORD ret, wake_bits, changed_bits;
 
     if (flags & ~(QS_ALLINPUT | QS_ALLPOSTMESSAGE | QS_SMRESULT))
     {
@@ -461,6 +598,13 @@ DWORD WINAPI GetQueueStatus( UINT flags )
 
     check_for_events( flags );
 
+    /* the server only needs to be called to clear the changed bits */
+    if (get_shared_queue_bits( &wake_bits, &changed_bits ) && !(changed_bits & flags))
+    {
+        interlocked_xchg_add( &shared_requests_avoided[SHARED_QUEUE_STATUS], 1 );
+        return MAKELONG( 0, wake_bits & flags );
+    }
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = flags;
@@ -477,10 +621,16 @@ DWORD WINAPI GetQueueStatus( UINT flags )
  */
 BOOL WINAPI GetInputState(void)
 {
-    DWORD ret;
+    DWORD ret, wake_bits, changed_bits;
 
     check_for_events( QS_INPUT );
 
+    if (get_shared_queue_bits( &wake_bits, &changed_bits ))
+    {
+        interlocked_xchg_add( &shared_requests_avoided[SHARED_QUEUE_STATUS], 1 );
+        return wake_bits & (QS_KEY | QS_MOUSEBUTTON);
+    }
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = 0;
@@ -2511,6 +2511,70 @@ static void test_GetKeyState(void)
     CloseHandle(semaphores[1]);
 }
 
+struct no_queue_params
+{
+    HWND hwnd;
+    HANDLE ready;
+    HANDLE done;
+};
+
+static DWORD WINAPI no_queue_thread(void *arg)
+{
+    struct no_queue_params *params = arg;
+    MSG msg;
+
+    /* none of these need a message queue */
+    ok(IsWindow(params->hwnd), "IsWindow failed\n");
+    GetAsyncKeyState(VK_SHIFT);
+    ok(!GetQueueStatus(QS_ALLINPUT), "unexpected queue status\n");
+    ok(!GetInputState(), "unexpected input state\n");
+    SetEvent(params->ready);
+    WaitForSingleObject(params->done, INFINITE);
+
+    PeekMessageA(&msg, NULL, 0, 0, PM_NOREMOVE);
+    SetEvent(params->ready);
+    WaitForSingleObject(params->done, INFINITE);
+    return 0;
+}
+
+static void test_no_queue(void)
+{
+    struct no_queue_params params;
+    HANDLE thread;
+    DWORD tid, result;
+    BOOL ret;
+
+    params.hwnd = CreateWindowA("static", "Title", WS_OVERLAPPEDWINDOW,
+                                10, 10, 200, 200, NULL, NULL, NULL, NULL);
+    ok(params.hwnd != NULL, "CreateWindowA failed %u\n", GetLastError());
+    params.ready = CreateEventA(NULL, FALSE, FALSE, NULL);
+    params.done = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+    thread = CreateThread(NULL, 0, no_queue_thread, &params, 0, &tid);
+    ok(thread != NULL, "CreateThread failed %u\n", GetLastError());
+    result = WaitForSingleObject(params.ready, 5000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", result);
+
+    SetLastError(0xdeadbeef);
+    ret = PostThreadMessageA(tid, WM_USER, 0, 0);
+    ok(!ret || broken(ret) /* the thread becomes a GUI thread */, "thread has a message queue\n");
+    if (!ret) ok(GetLastError() == ERROR_INVALID_THREAD_ID, "got error %u\n", GetLastError());
+
+    SetEvent(params.done);
+    result = WaitForSingleObject(params.ready, 5000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", result);
+    ret = PostThreadMessageA(tid, WM_USER, 0, 0);
+    ok(ret, "PostThreadMessage failed %u\n", GetLastError());
+
+    SetEvent(params.done);
+    result = WaitForSingleObject(thread, 5000);
+    ok(result == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", result);
+    CloseHandle(thread);
+    CloseHandle(params.ready);
+    CloseHandle(params.done);
+    DestroyWindow(params.hwnd);
+}
+
 static void test_OemKeyScan(void)
 {
     DWORD ret, expect, vkey, scan;
@@ -2568,6 +2632,7 @@ START_TEST(input)
     test_key_names();
     test_attach_input();
     test_GetKeyState();
+    test_no_queue();
     test_OemKeyScan();
 
     if(pGetMouseMovePointsEx)
@@ -33,6 +33,7 @@
 #include "wine/debug.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(graphics);
+WINE_DECLARE_DEBUG_CHANNEL(win);
 
 #define DESKTOP_ALL_ACCESS 0x01ff
 
@@ -377,6 +378,7 @@ static void thread_detach(void)
     destroy_thread_windows();
     CloseHandle( thread_info->server_queue );
     HeapFree( GetProcessHeap(), 0, thread_info->wmchar_data );
+    if (thread_info->key_state) free_shared_state( thread_info->key_state );
     HeapFree( GetProcessHeap(), 0, thread_info->key_state );
     HeapFree( GetProcessHeap(), 0, thread_info->rawinput );
 
@@ -407,6 +409,9 @@ BOOL WINAPI DllMain( HINSTANCE inst, DWORD reason, LPVOID reserved )
         thread_detach();
         break;
     case DLL_PROCESS_DETACH:
+        TRACE_(win)( "server requests avoided: %d key state, %d queue status, %d window info\n",
+                     shared_requests_avoided[SHARED_KEY_STATE], shared_requests_avoided[SHARED_QUEUE_STATUS],
+                     shared_requests_avoided[SHARED_WINDOW_INFO] );
         USER_unload_driver();
         FreeLibrary(imm32_module);
         DeleteCriticalSection(&user_section);
@@ -28,6 +28,7 @@
 #include "winuser.h"
 #include "winreg.h"
 #include "winternl.h"
+#include "wine/server_protocol.h"
 
 #define GET_WORD(ptr)  (*(const WORD *)(ptr))
 #define GET_DWORD(ptr) (*(const DWORD *)(ptr))
@@ -182,7 +183,7 @@ struct user_thread_info
     DWORD                         GetMessagePosVal;       /* Value for GetMessagePos */
     ULONG_PTR                     GetMessageExtraInfoVal; /* Value for GetMessageExtraInfo */
     UINT                          active_hooks;           /* Bitmap of active hooks */
-    struct user_key_state_info   *key_state;              /* Cache of global key state */
+    struct user_key_state_info   *key_state;              /* Cache of global key state and shared state */
     HWND                          top_window;             /* Desktop window */
     HWND                          msg_window;             /* HWND_MESSAGE parent window */
     RAWINPUT                     *rawinput;
@@ -199,8 +200,47 @@ struct user_key_state_info
     UINT                          time;                   /* Time of last key state refresh */
     INT                           counter;                /* Counter to invalidate the key state */
     BYTE                          state[256];             /* State for each key */
+    const desktop_shm_t          *desktop_shm;            /* Shared desktop state */
+    const queue_shm_t            *queue_shm;              /* Shared queue state */
+    BOOL                          shm_failed;             /* Shared state couldn't be mapped */
 };
 
+/* server requests avoided by reading the shared state */
+enum shared_request
+{
+    SHARED_KEY_STATE,
+    SHARED_QUEUE_STATUS,
+    SHARED_WINDOW_INFO,
+    NB_SHARED_REQUESTS
+};
+
+extern INT shared_requests_avoided[NB_SHARED_REQUESTS] DECLSPEC_HIDDEN;
+
+/* read side of the seqlocks protecting the shared state */
+static inline void shm_read_barrier(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__( "" : : : "memory" );
+#else
+    __sync_synchronize();
+#endif
+}
+
+static inline int shm_read_begin( const int *seq )
+{
+    int ret;
+
+    while ((ret = *(volatile const int *)seq) & 1) NtYieldExecution();
+    shm_read_barrier();
+    return ret;
+}
+
+static inline BOOL shm_read_retry( const int *seq, int prev )
+{
+    shm_read_barrier();
+    return *(volatile const int *)seq != prev;
+}
+
 struct hook_extra_info
 {
     HHOOK handle;
@@ -243,6 +283,9 @@ extern LRESULT call_current_hook( HHOOK hhook, INT code, WPARAM wparam, LPARAM l
 extern DWORD get_input_codepage( void ) DECLSPEC_HIDDEN;
 extern BOOL map_wparam_AtoW( UINT message, WPARAM *wparam, enum wm_char_mapping mapping ) DECLSPEC_HIDDEN;
 extern NTSTATUS send_hardware_message( HWND hwnd, const INPUT *input, UINT flags ) DECLSPEC_HIDDEN;
+extern struct user_key_state_info *get_shared_state(void) DECLSPEC_HIDDEN;
+extern void free_shared_state( struct user_key_state_info *info ) DECLSPEC_HIDDEN;
+extern const window_shm_t *get_shared_windows(void) DECLSPEC_HIDDEN;
 extern LRESULT MSG_SendInternalMessageTimeout( DWORD dest_pid, DWORD dest_tid,
                                                UINT msg, WPARAM wparam, LPARAM lparam,
                                                UINT flags, UINT timeout, PDWORD_PTR res_ptr ) DECLSPEC_HIDDEN;
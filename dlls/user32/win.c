@@ -345,6 +345,86 @@ static HWND *list_window_children( HDESK desktop, HWND hwnd, LPCWSTR class, DWOR
 }
 
 
+/*******************************************************************
+ *           get_shared_window
+ *
+ * Copy the state of a window from the table shared by the server.
+ * Returns FALSE if it has to be retrieved from the server instead.
+ */
+static BOOL get_shared_window( HWND hwnd, window_shm_t *info )
+{
+    const window_shm_t *windows, *shm;
+    UINT index = USER_HANDLE_TO_INDEX( hwnd );
+    int seq;
+
+    if (index >= NB_USER_HANDLES || !(windows = get_shared_windows())) return FALSE;
+    shm = &windows[index];
+    do
+    {
+        seq = shm_read_begin( &shm->seq );
+        *info = *shm;
+    } while (shm_read_retry( &shm->seq, seq ));
+    /* truncated and stale handles are resolved by the server */
+    return info->handle == HandleToUlong( hwnd );
+}
+
+
+/*******************************************************************
+ *           get_shared_rectangles
+ */
+static BOOL get_shared_rectangles( HWND hwnd, enum coords_relative relative, RECT *rectWindow, RECT *rectClient )
+{
+    window_shm_t info, parent;
+    RECT window_rect, client_rect, rect;
+    user_handle_t handle;
+
+    if (!get_shared_window( hwnd, &info )) return FALSE;
+    SetRect( &window_rect, info.window.left, info.window.top, info.window.right, info.window.bottom );
+    SetRect( &client_rect, info.client.left, info.client.top, info.client.right, info.client.bottom );
+
+    switch (relative)
+    {
+    case COORDS_CLIENT:
+        rect = client_rect;
+        OffsetRect( &window_rect, -rect.left, -rect.top );
+        OffsetRect( &client_rect, -rect.left, -rect.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &rect, &window_rect );
+        break;
+    case COORDS_WINDOW:
+        rect = window_rect;
+        OffsetRect( &window_rect, -rect.left, -rect.top );
+        OffsetRect( &client_rect, -rect.left, -rect.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &rect, &client_rect );
+        break;
+    case COORDS_PARENT:
+        if (!info.parent) break;
+        if (!get_shared_window( wine_server_ptr_handle( info.parent ), &parent )) return FALSE;
+        if (parent.ex_style & WS_EX_LAYOUTRTL)
+        {
+            SetRect( &rect, parent.client.left, parent.client.top, parent.client.right, parent.client.bottom );
+            mirror_rect( &rect, &window_rect );
+            mirror_rect( &rect, &client_rect );
+        }
+        break;
+    case COORDS_SCREEN:
+        for (handle = info.parent; handle; handle = parent.parent)
+        {
+            if (!get_shared_window( wine_server_ptr_handle( handle ), &parent )) return FALSE;
+            if (!parent.parent) break;  /* desktop window */
+            OffsetRect( &window_rect, parent.client.left, parent.client.top );
+            OffsetRect( &client_rect, parent.client.left, parent.client.top );
+        }
+        break;
+    default:
+        return FALSE;
+    }
+    if (rectWindow) *rectWindow = window_rect;
+    if (rectClient) *rectClient = client_rect;
+    interlocked_xchg_add( &shared_requests_avoided[SHARED_WINDOW_INFO], 1 );
+    return TRUE;
+}
+
+
 /*******************************************************************
  *           list_window_parents
  *
@@ -383,7 +463,31 @@ static HWND *list_window_parents( HWND hwnd )
         }
     }
 
-    /* at least one parent belongs to another process, have to query the server */
+    /* at least one parent belongs to another process, try the shared window table */
+
+    for (;;)
+    {
+        window_shm_t info;
+
+        if (!get_shared_window( current, &info )) break;
+        list[pos] = current = wine_server_ptr_handle( info.parent );
+        if (!current)
+        {
+            if (!pos) goto empty;
+            interlocked_xchg_add( &shared_requests_avoided[SHARED_WINDOW_INFO], 1 );
+            return list;
+        }
+        if (++pos == size - 1)
+        {
+            /* need to grow the list */
+            HWND *new_list = HeapReAlloc( GetProcessHeap(), 0, list, (size+16) * sizeof(HWND) );
+            if (!new_list) goto empty;
+            list = new_list;
+            size += 16;
+        }
+    }
+
+    /* have to query the server */
 
     for (;;)
     {
@@ -915,6 +1019,8 @@ BOOL WIN_GetRectangles( HWND hwnd, enum coords_relative relative, RECT *rectWind
     }
 
 other_process:
+    if (get_shared_rectangles( hwnd, relative, rectWindow, rectClient )) return TRUE;
+
     SERVER_START_REQ( get_window_rectangles )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -2255,11 +2361,29 @@ static LONG_PTR WIN_GetWindowLong( HWND hwnd, INT offset, UINT size, BOOL unicod
 
     if (wndPtr == WND_OTHER_PROCESS)
     {
+        window_shm_t info;
+
         if (offset == GWLP_WNDPROC)
         {
             SetLastError( ERROR_ACCESS_DENIED );
             return 0;
         }
+        if (offset < 0 && get_shared_window( hwnd, &info ))
+        {
+            switch(offset)
+            {
+            case GWL_STYLE:      retvalue = info.style; break;
+            case GWL_EXSTYLE:    retvalue = info.ex_style; break;
+            case GWLP_ID:        retvalue = info.id; break;
+            case GWLP_HINSTANCE: retvalue = (ULONG_PTR)wine_server_get_ptr( info.instance ); break;
+            case GWLP_USERDATA:  retvalue = info.user_data; break;
+            default:
+                SetLastError( ERROR_INVALID_INDEX );
+                break;
+            }
+            interlocked_xchg_add( &shared_requests_avoided[SHARED_WINDOW_INFO], 1 );
+            return retvalue;
+        }
         SERVER_START_REQ( set_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -2846,6 +2970,7 @@ INT WINAPI GetWindowTextLengthW( HWND hwnd )
  */
 BOOL WINAPI IsWindow( HWND hwnd )
 {
+    window_shm_t info;
     WND *ptr;
     BOOL ret;
 
@@ -2858,6 +2983,12 @@ BOOL WINAPI IsWindow( HWND hwnd )
         return TRUE;
     }
 
+    if (get_shared_window( hwnd, &info ))
+    {
+        interlocked_xchg_add( &shared_requests_avoided[SHARED_WINDOW_INFO], 1 );
+        return TRUE;
+    }
+
     /* check other processes */
     SERVER_START_REQ( get_window_info )
     {
@@ -2874,6 +3005,7 @@ BOOL WINAPI IsWindow( HWND hwnd )
  */
 DWORD WINAPI GetWindowThreadProcessId( HWND hwnd, LPDWORD process )
 {
+    window_shm_t info;
     WND *ptr;
     DWORD tid = 0;
 
@@ -2892,6 +3024,13 @@ DWORD WINAPI GetWindowThreadProcessId( HWND hwnd, LPDWORD process )
         return tid;
     }
 
+    if (get_shared_window( hwnd, &info ))
+    {
+        interlocked_xchg_add( &shared_requests_avoided[SHARED_WINDOW_INFO], 1 );
+        if (process) *process = info.pid;
+        return info.tid;
+    }
+
     /* check other processes */
     SERVER_START_REQ( get_window_info )
     {
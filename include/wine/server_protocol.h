@@ -252,6 +252,38 @@ typedef struct
 } rectangle_t;
 
 
+
+
+typedef struct
+{
+    unsigned char  keystate[256];
+} desktop_shm_t;
+
+typedef struct
+{
+    int            seq;
+    unsigned int   wake_bits;
+    unsigned int   changed_bits;
+    int            __pad;
+} queue_shm_t;
+
+typedef struct
+{
+    int            seq;
+    user_handle_t  handle;
+    user_handle_t  parent;
+    thread_id_t    tid;
+    process_id_t   pid;
+    unsigned int   style;
+    unsigned int   ex_style;
+    unsigned int   id;
+    mod_handle_t   instance;
+    lparam_t       user_data;
+    rectangle_t    window;
+    rectangle_t    client;
+} window_shm_t;
+
+
 typedef struct
 {
     obj_handle_t    handle;
@@ -749,6 +781,29 @@ struct new_process_reply
 
 
 
+struct spawn_process_request
+{
+    struct request_header __header;
+    int          socket_fd;
+    int          stdin_fd;
+    int          stdout_fd;
+    int          stderr_fd;
+    unsigned int create_flags;
+    data_size_t  loader_size;
+    data_size_t  argv_size;
+    data_size_t  env_size;
+    /* VARARG(data,bytes); */
+    char __pad_44[4];
+};
+struct spawn_process_reply
+{
+    struct reply_header __header;
+    int          pid;
+    char __pad_12[4];
+};
+
+
+
 struct get_new_process_info_request
 {
     struct request_header __header;
@@ -1499,6 +1554,8 @@ struct get_handle_fd_reply
     int          cacheable;
     unsigned int access;
     unsigned int options;
+    unsigned int comp_flags;
+    char __pad_28[4];
 };
 enum server_fd_type
 {
@@ -2255,7 +2312,25 @@ struct get_mapping_info_reply
     mem_size_t   size;
     unsigned int flags;
     obj_handle_t shared_file;
+    client_ptr_t relocated_base;
+    file_pos_t   relocated_size;
+    timeout_t    relocated_mtime;
+    obj_handle_t relocated_mapping;
     /* VARARG(image,pe_image_info); */
+    char __pad_52[4];
+};
+
+
+
+struct set_relocated_image_request
+{
+    struct request_header __header;
+    obj_handle_t mapping;
+    client_ptr_t base;
+};
+struct set_relocated_image_reply
+{
+    struct reply_header __header;
 };
 
 
@@ -3026,6 +3101,22 @@ struct get_queue_status_reply
 
 
 
+struct get_user_shared_memory_request
+{
+    struct request_header __header;
+    int          queue_only;
+};
+struct get_user_shared_memory_reply
+{
+    struct reply_header __header;
+    obj_handle_t windows;
+    obj_handle_t desktop;
+    obj_handle_t queue;
+    char __pad_20[4];
+};
+
+
+
 struct get_process_idle_event_request
 {
     struct request_header __header;
@@ -5311,6 +5402,28 @@ struct remove_completion_reply
 };
 
 
+struct completion_info
+{
+    apc_param_t   ckey;
+    apc_param_t   cvalue;
+    apc_param_t   information;
+    unsigned int  status;
+    int           __pad;
+};
+
+
+struct remove_completions_request
+{
+    struct request_header __header;
+    obj_handle_t  handle;
+};
+struct remove_completions_reply
+{
+    struct reply_header __header;
+    /* VARARG(data,completion_infos); */
+};
+
+
 
 struct query_completion_request
 {
@@ -5357,6 +5470,20 @@ struct add_fd_completion_reply
 
 
 
+struct set_fd_completion_mode_request
+{
+    struct request_header __header;
+    obj_handle_t   handle;
+    unsigned int   flags;
+    char __pad_20[4];
+};
+struct set_fd_completion_mode_reply
+{
+    struct reply_header __header;
+};
+
+
+
 struct set_fd_disp_info_request
 {
     struct request_header __header;
@@ -5696,6 +5823,7 @@ enum esync_type
 enum request
 {
     REQ_new_process,
+    REQ_spawn_process,
     REQ_get_new_process_info,
     REQ_new_thread,
     REQ_get_startup_info,
@@ -5781,6 +5909,7 @@ enum request
     REQ_create_mapping,
     REQ_open_mapping,
     REQ_get_mapping_info,
+    REQ_set_relocated_image,
     REQ_map_view,
     REQ_unmap_view,
     REQ_get_mapping_committed_range,
@@ -5830,6 +5959,7 @@ enum request
     REQ_set_queue_fd,
     REQ_set_queue_mask,
     REQ_get_queue_status,
+    REQ_get_user_shared_memory,
     REQ_get_process_idle_event,
     REQ_send_message,
     REQ_post_quit_message,
@@ -5964,9 +6094,11 @@ enum request
     REQ_open_completion,
     REQ_add_completion,
     REQ_remove_completion,
+    REQ_remove_completions,
     REQ_query_completion,
     REQ_set_completion_info,
     REQ_add_fd_completion,
+    REQ_set_fd_completion_mode,
     REQ_set_fd_disp_info,
     REQ_set_fd_name_info,
     REQ_get_window_layered_info,
@@ -5996,6 +6128,7 @@ union generic_request
     struct request_max_size max_size;
     struct request_header request_header;
     struct new_process_request new_process_request;
+    struct spawn_process_request spawn_process_request;
     struct get_new_process_info_request get_new_process_info_request;
     struct new_thread_request new_thread_request;
     struct get_startup_info_request get_startup_info_request;
@@ -6081,6 +6214,7 @@ union generic_request
     struct create_mapping_request create_mapping_request;
     struct open_mapping_request open_mapping_request;
     struct get_mapping_info_request get_mapping_info_request;
+    struct set_relocated_image_request set_relocated_image_request;
     struct map_view_request map_view_request;
     struct unmap_view_request unmap_view_request;
     struct get_mapping_committed_range_request get_mapping_committed_range_request;
@@ -6130,6 +6264,7 @@ union generic_request
     struct set_queue_fd_request set_queue_fd_request;
     struct set_queue_mask_request set_queue_mask_request;
     struct get_queue_status_request get_queue_status_request;
+    struct get_user_shared_memory_request get_user_shared_memory_request;
     struct get_process_idle_event_request get_process_idle_event_request;
     struct send_message_request send_message_request;
     struct post_quit_message_request post_quit_message_request;
@@ -6264,9 +6399,11 @@ union generic_request
     struct open_completion_request open_completion_request;
     struct add_completion_request add_completion_request;
     struct remove_completion_request remove_completion_request;
+    struct remove_completions_request remove_completions_request;
     struct query_completion_request query_completion_request;
     struct set_completion_info_request set_completion_info_request;
     struct add_fd_completion_request add_fd_completion_request;
+    struct set_fd_completion_mode_request set_fd_completion_mode_request;
     struct set_fd_disp_info_request set_fd_disp_info_request;
     struct set_fd_name_info_request set_fd_name_info_request;
     struct get_window_layered_info_request get_window_layered_info_request;
@@ -6294,6 +6431,7 @@ union generic_reply
     struct request_max_size max_size;
     struct reply_header reply_header;
     struct new_process_reply new_process_reply;
+    struct spawn_process_reply spawn_process_reply;
     struct get_new_process_info_reply get_new_process_info_reply;
     struct new_thread_reply new_thread_reply;
     struct get_startup_info_reply get_startup_info_reply;
@@ -6379,6 +6517,7 @@ union generic_reply
     struct create_mapping_reply create_mapping_reply;
     struct open_mapping_reply open_mapping_reply;
     struct get_mapping_info_reply get_mapping_info_reply;
+    struct set_relocated_image_reply set_relocated_image_reply;
     struct map_view_reply map_view_reply;
     struct unmap_view_reply unmap_view_reply;
     struct get_mapping_committed_range_reply get_mapping_committed_range_reply;
@@ -6428,6 +6567,7 @@ union generic_reply
     struct set_queue_fd_reply set_queue_fd_reply;
     struct set_queue_mask_reply set_queue_mask_reply;
     struct get_queue_status_reply get_queue_status_reply;
+    struct get_user_shared_memory_reply get_user_shared_memory_reply;
     struct get_process_idle_event_reply get_process_idle_event_reply;
     struct send_message_reply send_message_reply;
     struct post_quit_message_reply post_quit_message_reply;
@@ -6562,9 +6702,11 @@ union generic_reply
     struct open_completion_reply open_completion_reply;
     struct add_completion_reply add_completion_reply;
     struct remove_completion_reply remove_completion_reply;
+    struct remove_completions_reply remove_completions_reply;
     struct query_completion_reply query_completion_reply;
     struct set_completion_info_reply set_completion_info_reply;
     struct add_fd_completion_reply add_fd_completion_reply;
+    struct set_fd_completion_mode_reply set_fd_completion_mode_reply;
     struct set_fd_disp_info_reply set_fd_disp_info_reply;
     struct set_fd_name_info_reply set_fd_name_info_reply;
     struct get_window_layered_info_reply get_window_layered_info_reply;
@@ -6588,6 +6730,6 @@ union generic_reply
     struct get_esync_apc_fd_reply get_esync_apc_fd_reply;
 };
 
-#define SERVER_PROTOCOL_VERSION 557
+#define SERVER_PROTOCOL_VERSION 564
 
 #endif /* __WINE_WINE_SERVER_PROTOCOL_H */
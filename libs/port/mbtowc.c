@@ -19,6 +19,9 @@
  */
 
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "wine/unicode.h"
 
@@ -49,6 +52,20 @@ static inline int check_invalid_chars_sbcs( const struct sbcs_table *table, int
     return srclen;
 }
 
+#ifdef __SSE2__
+/* check whether the code page table maps 7-bit ASCII to itself */
+static inline int is_ascii_cp2uni( const WCHAR *cp2uni )
+{
+    static const WCHAR *last_ascii_table;
+    unsigned int i;
+
+    if (cp2uni == last_ascii_table) return 1;
+    for (i = 0; i < 0x80; i++) if (cp2uni[i] != i) return 0;
+    last_ascii_table = cp2uni;
+    return 1;
+}
+#endif
+
 /* mbstowcs for single-byte code page */
 /* all lengths are in characters, not bytes */
 static inline int mbstowcs_sbcs( const struct sbcs_table *table, int flags,
@@ -65,6 +82,28 @@ static inline int mbstowcs_sbcs( const struct sbcs_table *table, int flags,
         ret = -1;
     }
 
+#ifdef __SSE2__
+    /* 7-bit ASCII is converted 16 chars at a time by zero-extending it */
+    if (srclen >= 16 && is_ascii_cp2uni( cp2uni ))
+    {
+        const __m128i zero = _mm_setzero_si128();
+
+        for ( ; srclen >= 16; src += 16, dst += 16, srclen -= 16)
+        {
+            __m128i chars = _mm_loadu_si128( (const __m128i *)src );
+            unsigned int i;
+
+            if (_mm_movemask_epi8( chars ))
+            {
+                for (i = 0; i < 16; i++) dst[i] = cp2uni[src[i]];
+                continue;
+            }
+            _mm_storeu_si128( (__m128i *)dst, _mm_unpacklo_epi8( chars, zero ));
+            _mm_storeu_si128( (__m128i *)(dst + 8), _mm_unpackhi_epi8( chars, zero ));
+        }
+    }
+#endif
+
     for (;;)
     {
         switch(srclen)
@@ -19,6 +19,9 @@
  */
 
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "wine/unicode.h"
 
@@ -44,6 +47,72 @@ static const unsigned char utf8_mask[4] = { 0x7f, 0x1f, 0x0f, 0x07 };
 static const unsigned int utf8_minval[4] = { 0x0, 0x80, 0x800, 0x10000 };
 
 
+/* length of the run of 7-bit ASCII chars at the start of a wide string, in blocks of 8 chars */
+static inline unsigned int ascii_run_wcs( const WCHAR *src, unsigned int srclen )
+{
+    unsigned int i = 0;
+#ifdef __SSE2__
+    const __m128i mask = _mm_set1_epi16( (short)0xff80 ), zero = _mm_setzero_si128();
+
+    for (; i + 8 <= srclen; i += 8)
+    {
+        __m128i chars = _mm_loadu_si128( (const __m128i *)(src + i) );
+        if (_mm_movemask_epi8( _mm_cmpeq_epi16( _mm_and_si128( chars, mask ), zero )) != 0xffff) break;
+    }
+#endif
+    return i;
+}
+
+/* length of the run of 7-bit ASCII chars at the start of a byte string, in blocks of 16 chars */
+static inline unsigned int ascii_run_mbs( const char *src, unsigned int srclen )
+{
+    unsigned int i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= srclen; i += 16)
+        if (_mm_movemask_epi8( _mm_loadu_si128( (const __m128i *)(src + i) ))) break;
+#endif
+    return i;
+}
+
+/* convert a run of 7-bit ASCII chars to UTF-8, returns the number of chars converted */
+static inline unsigned int ascii_wcstombs( const WCHAR *src, unsigned int srclen, char *dst, unsigned int dstlen )
+{
+    unsigned int i = 0;
+#ifdef __SSE2__
+    const __m128i mask = _mm_set1_epi16( (short)0xff80 ), zero = _mm_setzero_si128();
+    unsigned int len = srclen < dstlen ? srclen : dstlen;
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i lo = _mm_loadu_si128( (const __m128i *)(src + i) );
+        __m128i hi = _mm_loadu_si128( (const __m128i *)(src + i + 8) );
+        __m128i bits = _mm_and_si128( _mm_or_si128( lo, hi ), mask );
+        if (_mm_movemask_epi8( _mm_cmpeq_epi16( bits, zero )) != 0xffff) break;
+        _mm_storeu_si128( (__m128i *)(dst + i), _mm_packus_epi16( lo, hi ));
+    }
+#endif
+    return i;
+}
+
+/* convert a run of 7-bit ASCII chars from UTF-8, returns the number of chars converted */
+static inline unsigned int ascii_mbstowcs( const char *src, unsigned int srclen, WCHAR *dst, unsigned int dstlen )
+{
+    unsigned int i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    unsigned int len = srclen < dstlen ? srclen : dstlen;
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128( (const __m128i *)(src + i) );
+        if (_mm_movemask_epi8( chars )) break;
+        _mm_storeu_si128( (__m128i *)(dst + i), _mm_unpacklo_epi8( chars, zero ));
+        _mm_storeu_si128( (__m128i *)(dst + i + 8), _mm_unpackhi_epi8( chars, zero ));
+    }
+#endif
+    return i;
+}
+
 /* get the next char value taking surrogates into account */
 static inline unsigned int get_surrogate_value( const WCHAR *src, unsigned int srclen )
 {
@@ -68,7 +137,10 @@ static inline int get_length_wcs_utf8( int flags, const WCHAR *src, unsigned int
     {
         if (*src < 0x80)  /* 0x00-0x7f: 1 byte */
         {
-            len++;
+            unsigned int run = ascii_run_wcs( src + 1, srclen - 1 );
+            len += run + 1;
+            src += run;
+            srclen -= run;
             continue;
         }
         if (*src < 0x800)  /* 0x80-0x7ff: 2 bytes */
@@ -108,8 +180,15 @@ int wine_utf8_wcstombs( int flags, const WCHAR *src, int srclen, char *dst, int
 
         if (ch < 0x80)  /* 0x00-0x7f: 1 byte */
         {
+            unsigned int run;
+
             if (!len--) return -1;  /* overflow */
             *dst++ = ch;
+            run = ascii_wcstombs( src + 1, srclen - 1, dst, len );
+            src += run;
+            srclen -= run;
+            dst += run;
+            len -= run;
             continue;
         }
 
@@ -285,7 +364,9 @@ static inline int get_length_mbs_utf8( int flags, const char *src, int srclen )
         unsigned char ch = *src++;
         if (ch < 0x80)  /* special fast case for 7-bit ASCII */
         {
-            ret++;
+            unsigned int run = ascii_run_mbs( src, srcend - src );
+            ret += run + 1;
+            src += run;
             continue;
         }
         if ((res = decode_utf8_char( ch, &src, srcend )) <= 0x10ffff)
@@ -316,7 +397,12 @@ int wine_utf8_mbstowcs( int flags, const char *src, int srclen, WCHAR *dst, int
         unsigned char ch = *src++;
         if (ch < 0x80)  /* special fast case for 7-bit ASCII */
         {
+            unsigned int run;
+
             *dst++ = ch;
+            run = ascii_mbstowcs( src, srcend - src, dst, dstend - dst );
+            src += run;
+            dst += run;
             continue;
         }
         if ((res = decode_utf8_char( ch, &src, srcend )) <= 0xffff)
@@ -19,6 +19,9 @@
  */
 
 #include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "wine/unicode.h"
 
@@ -88,6 +91,21 @@ static int get_length_sbcs( const struct sbcs_table *table, int flags,
     return ret;
 }
 
+#ifdef __SSE2__
+/* check whether the code page table maps 7-bit ASCII to itself */
+static inline int is_ascii_uni2cp( const struct sbcs_table *table )
+{
+    static const struct sbcs_table *last_ascii_table;
+    unsigned int i;
+
+    if (table == last_ascii_table) return 1;
+    for (i = 0; i < 0x80; i++)
+        if (table->uni2cp_low[table->uni2cp_high[0] + i] != i) return 0;
+    last_ascii_table = table;
+    return 1;
+}
+#endif
+
 /* wcstombs for single-byte code page */
 static inline int wcstombs_sbcs( const struct sbcs_table *table,
                                  const WCHAR *src, unsigned int srclen,
@@ -104,6 +122,29 @@ static inline int wcstombs_sbcs( const struct sbcs_table *table,
         ret = -1;
     }
 
+#ifdef __SSE2__
+    /* 7-bit ASCII is converted 16 chars at a time by packing it */
+    if (srclen >= 16 && is_ascii_uni2cp( table ))
+    {
+        const __m128i mask = _mm_set1_epi16( (short)0xff80 ), zero = _mm_setzero_si128();
+
+        for ( ; srclen >= 16; src += 16, dst += 16, srclen -= 16)
+        {
+            __m128i lo = _mm_loadu_si128( (const __m128i *)src );
+            __m128i hi = _mm_loadu_si128( (const __m128i *)(src + 8) );
+            __m128i bits = _mm_and_si128( _mm_or_si128( lo, hi ), mask );
+            unsigned int i;
+
+            if (_mm_movemask_epi8( _mm_cmpeq_epi16( bits, zero )) != 0xffff)
+            {
+                for (i = 0; i < 16; i++) dst[i] = uni2cp_low[uni2cp_high[src[i] >> 8] + (src[i] & 0xff)];
+                continue;
+            }
+            _mm_storeu_si128( (__m128i *)dst, _mm_packus_epi16( lo, hi ));
+        }
+    }
+#endif
+
     while (srclen >= 16)
     {
         dst[0]  = uni2cp_low[uni2cp_high[src[0]  >> 8] + (src[0]  & 0xff)];
@@ -19,6 +19,10 @@
  */
 #include "wine/unicode.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 extern unsigned int wine_decompose( WCHAR ch, WCHAR *dst, unsigned int dstlen );
 extern const unsigned int collation_table[];
 
@@ -153,16 +157,52 @@ int wine_get_sortkey(int flags, const WCHAR *src, int srclen, char *dst, int dst
     return key_ptr[3] - dst;
 }
 
-static inline int compare_unicode_weights(int flags, const WCHAR *str1, int len1,
-                                          const WCHAR *str2, int len2)
+/* return the length of the common prefix of two strings */
+static inline int get_common_prefix(const WCHAR *str1, const WCHAR *str2, int len)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    while (i + 8 <= len)
+    {
+        __m128i a, b;
+        unsigned int mask;
+
+        /* the strings may end at the first difference, so never let a load
+         * cross into the next page: it may not be accessible */
+        if (((size_t)(str1 + i) & 0xfff) > 0x1000 - sizeof(a) ||
+            ((size_t)(str2 + i) & 0xfff) > 0x1000 - sizeof(b))
+        {
+            if (str1[i] != str2[i]) return i;
+            i++;
+            continue;
+        }
+        a = _mm_loadu_si128((const __m128i *)(str1 + i));
+        b = _mm_loadu_si128((const __m128i *)(str2 + i));
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi16(a, b));
+        if (mask != 0xffff) return i + (__builtin_ctz(~mask) >> 1);
+        i += 8;
+    }
+#endif
+    while (i < len && str1[i] == str2[i]) i++;
+    return i;
+}
+
+/* compare the unicode weights, recording the first diacritic and case
+ * weight differences on the way. Those are only valid if both strings
+ * were walked in step, i.e. no hyphen or apostrophe was skipped.
+ */
+static inline int compare_weights(int flags, const WCHAR *str1, int len1,
+                                  const WCHAR *str2, int len2, int *in_step)
 {
     unsigned int ce1, ce2;
-    int ret;
+    int ret, diacritic = 0, case_weight = 0;
 
     /* 32-bit collation element table format:
      * unicode weight - high 16 bit, diacritic weight - high 8 bit of low 16 bit,
      * case weight - high 4 bit of low 8 bit.
      */
+    *in_step = 1;
     while (len1 > 0 && len2 > 0)
     {
         if (flags & NORM_IGNORESYMBOLS)
@@ -195,6 +235,7 @@ static inline int compare_unicode_weights(int flags, const WCHAR *str1, int len1
                 {
                     str1++;
                     len1--;
+                    *in_step = 0;
                     continue;
                 }
             }
@@ -202,6 +243,7 @@ static inline int compare_unicode_weights(int flags, const WCHAR *str1, int len1
             {
                 str2++;
                 len2--;
+                *in_step = 0;
                 continue;
             }
         }
@@ -210,11 +252,12 @@ static inline int compare_unicode_weights(int flags, const WCHAR *str1, int len1
         ce2 = collation_table[collation_table[*str2 >> 8] + (*str2 & 0xff)];
 
         if (ce1 != (unsigned int)-1 && ce2 != (unsigned int)-1)
-            ret = (ce1 >> 16) - (ce2 >> 16);
-        else
-            ret = *str1 - *str2;
-
-        if (ret) return ret;
+        {
+            if ((ret = (ce1 >> 16) - (ce2 >> 16))) return ret;
+            if (!diacritic) diacritic = ((ce1 >> 8) & 0xff) - ((ce2 >> 8) & 0xff);
+            if (!case_weight) case_weight = ((ce1 >> 4) & 0x0f) - ((ce2 >> 4) & 0x0f);
+        }
+        else if ((ret = *str1 - *str2)) return ret;
 
         str1++;
         str2++;
@@ -231,7 +274,10 @@ static inline int compare_unicode_weights(int flags, const WCHAR *str1, int len1
         str2++;
         len2--;
     }
-    return len1 - len2;
+    if ((ret = len1 - len2) || !*in_step) return ret;
+    if (!(flags & NORM_IGNORENONSPACE) && diacritic) return diacritic;
+    if (!(flags & NORM_IGNORECASE)) return case_weight;
+    return 0;
 }
 
 static inline int compare_diacritic_weights(int flags, const WCHAR *str1, int len1,
@@ -355,10 +401,17 @@ static inline int compare_case_weights(int flags, const WCHAR *str1, int len1,
 int wine_compare_string(int flags, const WCHAR *str1, int len1,
                         const WCHAR *str2, int len2)
 {
-    int ret;
+    int ret, in_step, prefix = 0;
+
+    /* identical characters compare equal in all passes */
+    if (len1 > 0 && len2 > 0) prefix = get_common_prefix(str1, str2, len1 < len2 ? len1 : len2);
+    str1 += prefix;
+    str2 += prefix;
+    len1 -= prefix;
+    len2 -= prefix;
 
-    ret = compare_unicode_weights(flags, str1, len1, str2, len2);
-    if (!ret)
+    ret = compare_weights(flags, str1, len1, str2, len2, &in_step);
+    if (!ret && !in_step)
     {
         if (!(flags & NORM_IGNORENONSPACE))
             ret = compare_diacritic_weights(flags, str1, len1, str2, len2);
@@ -1012,7 +1012,7 @@ static void update_wineprefix( BOOL force )
     if (update_timestamp( config_dir, st.st_mtime ) || force)
     {
         HANDLE process;
-        DWORD count = 0;
+        DWORD count = 0, start = GetTickCount();
 
         if ((process = start_rundll32( inf_path, FALSE )))
         {
@@ -1030,6 +1030,7 @@ static void update_wineprefix( BOOL force )
             }
 /*            DestroyWindow( hwnd );*/
         }
+        WINE_TRACE( "prefix update took %u ms\n", GetTickCount() - start );
         WINE_MESSAGE( "wine: configuration in '%s' has been updated.\n", config_dir );
     }
 
@@ -851,6 +851,9 @@ enum dbg_start dbg_active_auto(int argc, char* argv[])
     enum dbg_start      ds = start_error_parse;
 
     DBG_IVAR(BreakOnDllLoad) = 0;
+    /* the backtrace only needs the debug info for the addresses it goes through,
+     * so let dbghelp parse the DWARF compilation units on demand */
+    SymSetOptions(SymGetOptions() | 0x20000000);
 
     /* auto mode */
     argc--; argv++;
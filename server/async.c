@@ -378,11 +378,14 @@ void async_set_result( struct object *obj, unsigned int status, apc_param_t tota
             data.user.args[2] = 0;
             thread_queue_apc( NULL, async->thread, NULL, &data );
         }
-        else if (async->data.apc_context)
+        else if (async->data.apc_context &&
+                 !(async->direct_result && status == STATUS_SUCCESS && async->fd &&
+                   (get_fd_comp_flags( async->fd ) & FILE_SKIP_COMPLETION_PORT_ON_SUCCESS)))
             add_async_completion( async, async->data.apc_context, status, total );
 
         if (async->event) set_event( async->event );
-        else if (async->fd) set_fd_signaled( async->fd, 1 );
+        else if (async->fd && !(get_fd_comp_flags( async->fd ) & FILE_SKIP_SET_EVENT_ON_HANDLE))
+            set_fd_signaled( async->fd, 1 );
         if (!async->signaled)
         {
             async->signaled = 1;
@@ -241,6 +241,39 @@ DECL_HANDLER(remove_completion)
     release_object( completion );
 }
 
+/* get as many completions as fit in the reply from completion port */
+DECL_HANDLER(remove_completions)
+{
+    struct completion* completion = get_completion_obj( current->process, req->handle, IO_COMPLETION_MODIFY_STATE );
+    struct completion_info *info;
+    struct comp_msg *msg;
+    unsigned int count;
+
+    if (!completion) return;
+
+    count = min( completion->depth, get_reply_max_size() / sizeof(*info) );
+    if (!count)
+        set_error( STATUS_PENDING );
+    else if ((info = set_reply_data_size( count * sizeof(*info) )))
+    {
+        while (count--)
+        {
+            msg = LIST_ENTRY( list_head( &completion->queue ), struct comp_msg, queue_entry );
+            list_remove( &msg->queue_entry );
+            completion->depth--;
+            info->ckey        = msg->ckey;
+            info->cvalue      = msg->cvalue;
+            info->information = msg->information;
+            info->status      = msg->status;
+            info->__pad       = 0;
+            info++;
+            free( msg );
+        }
+    }
+
+    release_object( completion );
+}
+
 /* get queue depth for completion port */
 DECL_HANDLER(query_completion)
 {
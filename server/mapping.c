@@ -119,6 +119,46 @@ static const struct object_ops shared_map_ops =
 
 static struct list shared_map_list = LIST_INIT( shared_map_list );
 
+/* copy of a PE image relocated by a process, that other processes can map at the same address */
+struct relocated_map
+{
+    struct object   obj;             /* object header */
+    struct fd      *fd;              /* file descriptor of the mapped PE file */
+    struct mapping *mapping;         /* anonymous mapping holding the relocated image */
+    client_ptr_t    base;            /* address the image was relocated to */
+    file_pos_t      file_size;       /* size of the PE file when it was relocated */
+    timeout_t       file_mtime;      /* modification time of the PE file when it was relocated */
+    struct list     entry;           /* entry in global relocated maps list */
+};
+
+static void relocated_map_dump( struct object *obj, int verbose );
+static void relocated_map_destroy( struct object *obj );
+
+static const struct object_ops relocated_map_ops =
+{
+    sizeof(struct relocated_map), /* size */
+    relocated_map_dump,        /* dump */
+    no_get_type,               /* get_type */
+    no_add_queue,              /* add_queue */
+    NULL,                      /* remove_queue */
+    NULL,                      /* signaled */
+    NULL,                      /* get_esync_fd */
+    NULL,                      /* satisfied */
+    no_signal,                 /* signal */
+    no_get_fd,                 /* get_fd */
+    no_map_access,             /* map_access */
+    default_get_sd,            /* get_sd */
+    default_set_sd,            /* set_sd */
+    no_lookup_name,            /* lookup_name */
+    no_link_name,              /* link_name */
+    NULL,                      /* unlink_name */
+    no_open_file,              /* open_file */
+    no_close_handle,           /* close_handle */
+    relocated_map_destroy      /* destroy */
+};
+
+static struct list relocated_map_list = LIST_INIT( relocated_map_list );
+
 /* memory view mapped in client address space */
 struct memory_view
 {
@@ -126,6 +166,7 @@ struct memory_view
     struct fd      *fd;              /* fd for mapped file */
     struct ranges  *committed;       /* list of committed ranges in this mapping */
     struct shared_map *shared;       /* temp file for shared PE mapping */
+    struct relocated_map *relocated; /* relocated copy of the PE image */
     unsigned int    flags;           /* SEC_* flags */
     client_ptr_t    base;            /* view base address (in process addr space) */
     mem_size_t      size;            /* view size */
@@ -220,6 +261,22 @@ static void shared_map_destroy( struct object *obj )
     list_remove( &shared->entry );
 }
 
+static void relocated_map_dump( struct object *obj, int verbose )
+{
+    struct relocated_map *relocated = (struct relocated_map *)obj;
+    fprintf( stderr, "Relocated mapping fd=%p mapping=%p base=%08x%08x\n", relocated->fd, relocated->mapping,
+             (unsigned int)(relocated->base >> 32), (unsigned int)relocated->base );
+}
+
+static void relocated_map_destroy( struct object *obj )
+{
+    struct relocated_map *relocated = (struct relocated_map *)obj;
+
+    release_object( relocated->fd );
+    release_object( relocated->mapping );
+    list_remove( &relocated->entry );
+}
+
 /* extend a file beyond the current end of file */
 static int grow_file( int unix_fd, file_pos_t new_size )
 {
@@ -316,6 +373,7 @@ static void free_memory_view( struct memory_view *view )
     if (view->fd) release_object( view->fd );
     if (view->committed) release_object( view->committed );
     if (view->shared) release_object( view->shared );
+    if (view->relocated) release_object( view->relocated );
     list_remove( &view->entry );
     free( view );
 }
@@ -340,6 +398,39 @@ static struct shared_map *get_shared_file( struct fd *fd )
     return NULL;
 }
 
+/* retrieve the size and modification time of a PE file */
+static int get_file_stamp( struct fd *fd, file_pos_t *size, timeout_t *mtime )
+{
+    static const timeout_t ticks_1601_to_1970 = (timeout_t)86400 * (369 * 365 + 89) * TICKS_PER_SEC;
+    struct stat st;
+
+    if (fstat( get_unix_fd( fd ), &st ) == -1) return 0;
+    *size  = st.st_size;
+    *mtime = (timeout_t)st.st_mtime * TICKS_PER_SEC + ticks_1601_to_1970;
+    return 1;
+}
+
+/* find the relocated copy of a given PE file */
+static struct relocated_map *get_relocated_map( struct fd *fd )
+{
+    struct relocated_map *ptr;
+    file_pos_t size;
+    timeout_t mtime;
+
+    if (!fd) return NULL;
+    LIST_FOR_EACH_ENTRY( ptr, &relocated_map_list, struct relocated_map, entry )
+    {
+        if (!is_same_file_fd( ptr->fd, fd )) continue;
+        if (get_file_stamp( fd, &size, &mtime ) && size == ptr->file_size && mtime == ptr->file_mtime)
+            return ptr;
+        /* the file has been modified since, drop the copy; existing views keep it alive */
+        list_remove( &ptr->entry );
+        list_init( &ptr->entry );
+        return NULL;
+    }
+    return NULL;
+}
+
 /* return the size of the memory mapping and file range of a given section */
 static inline void get_section_sizes( const IMAGE_SECTION_HEADER *sec, size_t *map_size,
                                       off_t *file_start, size_t *file_size )
@@ -851,6 +942,35 @@ static struct object *create_mapping( struct object *root, const struct unicode_
     return NULL;
 }
 
+/* create an anonymous mapping that is also mapped writable in the server, to share state with clients */
+struct object *create_shared_mapping( mem_size_t size, void **ptr )
+{
+    struct mapping *mapping;
+    void *base;
+
+    if (!(mapping = (struct mapping *)create_mapping( NULL, NULL, 0, size, SEC_COMMIT, 0, 0, NULL )))
+        return NULL;
+    base = mmap( NULL, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, get_unix_fd( mapping->fd ), 0 );
+    if (base == MAP_FAILED)
+    {
+        file_set_error();
+        release_object( mapping );
+        return NULL;
+    }
+    *ptr = base;
+    return &mapping->obj;
+}
+
+/* release a mapping created with create_shared_mapping */
+void free_shared_mapping( struct object *obj, void *ptr )
+{
+    struct mapping *mapping = (struct mapping *)obj;
+
+    assert( obj->ops == &mapping_ops );
+    munmap( ptr, mapping->size );
+    release_object( mapping );
+}
+
 struct mapping *get_mapping_obj( struct process *process, obj_handle_t handle, unsigned int access )
 {
     return (struct mapping *)get_handle_obj( process, handle, access, &mapping_ops );
@@ -954,6 +1074,7 @@ DECL_HANDLER(open_mapping)
 DECL_HANDLER(get_mapping_info)
 {
     struct mapping *mapping;
+    struct relocated_map *relocated = NULL;
 
     if (!(mapping = get_mapping_obj( current->process, req->handle, req->access ))) return;
 
@@ -961,7 +1082,15 @@ DECL_HANDLER(get_mapping_info)
     reply->flags   = mapping->flags;
 
     if (mapping->flags & SEC_IMAGE)
+    {
         set_reply_data( &mapping->image, min( sizeof(mapping->image), get_reply_max_size() ));
+        if ((relocated = get_relocated_map( mapping->fd )))
+        {
+            reply->relocated_base  = relocated->base;
+            reply->relocated_size  = relocated->file_size;
+            reply->relocated_mtime = relocated->file_mtime;
+        }
+    }
 
     if (!(req->access & (SECTION_MAP_READ | SECTION_MAP_WRITE)))  /* query only */
     {
@@ -972,9 +1101,56 @@ DECL_HANDLER(get_mapping_info)
     if (mapping->shared)
         reply->shared_file = alloc_handle( current->process, mapping->shared->file,
                                            GENERIC_READ|GENERIC_WRITE, 0 );
+    if (relocated)
+        reply->relocated_mapping = alloc_handle( current->process, relocated->mapping,
+                                                 SECTION_MAP_READ, 0 );
     release_object( mapping );
 }
 
+/* share a relocated copy of a PE image */
+DECL_HANDLER(set_relocated_image)
+{
+    struct memory_view *view = find_mapped_view( current->process, req->base );
+    struct relocated_map *relocated;
+    struct mapping *mapping;
+    file_pos_t file_size;
+    timeout_t file_mtime;
+
+    if (!view) return;
+    if (!(view->flags & SEC_IMAGE) || !view->fd)
+    {
+        set_error( STATUS_INVALID_PARAMETER );
+        return;
+    }
+    if (view->relocated || get_relocated_map( view->fd )) return;  /* already shared */
+
+    if (!(mapping = get_mapping_obj( current->process, req->mapping, SECTION_MAP_READ ))) return;
+    if ((mapping->flags & SEC_IMAGE) || mapping->size < view->size)
+    {
+        set_error( STATUS_INVALID_PARAMETER );
+        release_object( mapping );
+        return;
+    }
+    if (!get_file_stamp( view->fd, &file_size, &file_mtime ))
+    {
+        file_set_error();
+        release_object( mapping );
+        return;
+    }
+    if (!(relocated = alloc_object( &relocated_map_ops )))
+    {
+        release_object( mapping );
+        return;
+    }
+    relocated->fd         = (struct fd *)grab_object( view->fd );
+    relocated->mapping    = mapping;
+    relocated->base       = view->base;
+    relocated->file_size  = file_size;
+    relocated->file_mtime = file_mtime;
+    list_add_head( &relocated_map_list, &relocated->entry );
+    view->relocated = relocated;
+}
+
 /* add a memory view in the current process */
 DECL_HANDLER(map_view)
 {
@@ -1023,6 +1199,9 @@ DECL_HANDLER(map_view)
         view->fd        = !is_fd_removable( mapping->fd ) ? (struct fd *)grab_object( mapping->fd ) : NULL;
         view->committed = mapping->committed ? (struct ranges *)grab_object( mapping->committed ) : NULL;
         view->shared    = mapping->shared ? (struct shared_map *)grab_object( mapping->shared ) : NULL;
+        view->relocated = NULL;
+        if ((mapping->flags & SEC_IMAGE) && view->fd && (view->relocated = get_relocated_map( view->fd )))
+            grab_object( view->relocated );
         list_add_tail( &current->process->views, &view->entry );
     }
 
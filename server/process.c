@@ -22,6 +22,9 @@
 #include "wine/port.h"
 
 #include <assert.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <signal.h>
 #include <string.h>
@@ -40,6 +43,7 @@
 #include "ntstatus.h"
 #define WIN32_NO_STATUS
 #include "winternl.h"
+#include "wine/library.h"
 
 #include "file.h"
 #include "handle.h"
@@ -1274,6 +1278,122 @@ DECL_HANDLER(new_process)
     release_object( info );
 }
 
+/* split a buffer of null-terminated strings into a null-terminated array, leaving room for reserved entries */
+static char **build_string_array( char *data, data_size_t size, unsigned int reserved )
+{
+    char **array, *p;
+    unsigned int i, count = reserved;
+
+    for (p = data; p < data + size; p += strlen( p ) + 1) count++;
+    if (!(array = mem_alloc( (count + 1) * sizeof(*array) ))) return NULL;
+    for (i = 0; i < reserved; i++) array[i] = NULL;
+    for (p = data; p < data + size; p += strlen( p ) + 1) array[i++] = p;
+    array[i] = NULL;
+    return array;
+}
+
+/* close all file descriptors starting from a given one */
+static void close_fds_from( int first )
+{
+    int fd, max_fd;
+#ifdef linux
+    DIR *dir;
+    struct dirent *de;
+
+    if ((dir = opendir( "/proc/self/fd" )))
+    {
+        while ((de = readdir( dir )))
+        {
+            fd = atoi( de->d_name );
+            if (fd >= first && fd != dirfd( dir )) close( fd );
+        }
+        closedir( dir );
+        return;
+    }
+#endif
+    max_fd = getdtablesize();
+    for (fd = first; fd < max_fd; fd++) close( fd );
+}
+
+/* exec the new process in the child forked by spawn_process */
+static void exec_spawned_process( int fds[4], unsigned int flags, const char *loader,
+                                  char **argv, char **env, const char *unixdir )
+{
+    static char socket_env[] = "WINESERVERSOCKET=3";
+    sigset_t sigset;
+    int i, null_fd;
+
+    sigemptyset( &sigset );
+    sigprocmask( SIG_SETMASK, &sigset, NULL );
+    signal( SIGPIPE, SIG_DFL );
+    signal( SIGXFSZ, SIG_DFL );
+
+    if (flags & (CREATE_NEW_PROCESS_GROUP | CREATE_NEW_CONSOLE | DETACHED_PROCESS)) setsid();
+
+    /* move everything above the target fds first */
+    for (i = 0; i < 4; i++) if (fds[i] != -1) fds[i] = fcntl( fds[i], F_DUPFD, 4 );
+    if ((null_fd = open( "/dev/null", O_RDWR )) != -1 && null_fd < 4) null_fd = fcntl( null_fd, F_DUPFD, 4 );
+    for (i = 0; i < 4; i++) dup2( fds[i] != -1 ? fds[i] : null_fd, i );
+    close_fds_from( 4 );
+
+    environ = env;
+    putenv( socket_env );
+    if (chdir( unixdir ) == -1) fprintf( stderr, "wineserver: cannot chdir to %s\n", unixdir );
+
+    wine_exec_wine_binary( loader, argv, getenv( "WINELOADER" ));
+    _exit(1);
+}
+
+/* Start the Unix process for a new process on behalf of the parent */
+DECL_HANDLER(spawn_process)
+{
+    data_size_t size = get_req_data_size();
+    data_size_t env_end = req->loader_size + req->argv_size + req->env_size;
+    char *data = NULL, **argv = NULL, **env = NULL;
+    int i, fds[4];
+    pid_t pid;
+
+    fds[0] = req->stdin_fd != -1 ? thread_get_inflight_fd( current, req->stdin_fd ) : -1;
+    fds[1] = req->stdout_fd != -1 ? thread_get_inflight_fd( current, req->stdout_fd ) : -1;
+    fds[2] = req->stderr_fd != -1 ? thread_get_inflight_fd( current, req->stderr_fd ) : -1;
+    fds[3] = thread_get_inflight_fd( current, req->socket_fd );
+
+#ifndef USE_PTRACE
+    /* the child can only be reaped when SIGCHLD is handled */
+    set_error( STATUS_NOT_SUPPORTED );
+    goto done;
+#endif
+    if (fds[3] == -1 || shutdown_stage)
+    {
+        set_error( fds[3] == -1 ? STATUS_INVALID_PARAMETER : STATUS_SHUTDOWN_IN_PROGRESS );
+        goto done;
+    }
+
+    /* every part must be a non-empty list of null-terminated strings, except the environment */
+    if (!req->loader_size || !req->argv_size || env_end >= size || env_end < req->loader_size ||
+        !(data = memdup( get_req_data(), size )) ||
+        data[req->loader_size - 1] || data[req->loader_size + req->argv_size - 1] ||
+        (req->env_size && data[env_end - 1]) || data[size - 1])
+    {
+        if (!get_error()) set_error( STATUS_INVALID_PARAMETER );
+        goto done;
+    }
+    if (!(argv = build_string_array( data + req->loader_size, req->argv_size, 1 ))) goto done;
+    if (!(env = build_string_array( data + req->loader_size + req->argv_size, req->env_size, 0 ))) goto done;
+
+    if (!(pid = fork()))
+        exec_spawned_process( fds, req->create_flags, data, argv, env, data + env_end );
+
+    if (pid == -1) file_set_error();
+    else reply->pid = pid;
+
+done:
+    for (i = 0; i < 4; i++) if (fds[i] != -1) close( fds[i] );
+    free( env );
+    free( argv );
+    free( data );
+}
+
 /* Retrieve information about a newly started process */
 DECL_HANDLER(get_new_process_info)
 {
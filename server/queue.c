@@ -142,6 +142,8 @@ struct msg_queue
     struct hook_table     *hooks;           /* hook table */
     timeout_t              last_get_msg;    /* time of last get message call */
     int                    esync_fd;        /* esync file descriptor (signalled on message) */
+    struct object         *shared_mapping;  /* mapping for the shared queue state */
+    queue_shm_t           *shared;          /* shared queue state */
 };
 
 struct hotkey
@@ -304,6 +306,8 @@ static struct msg_queue *create_msg_queue( struct thread *thread, struct thread_
         queue->hooks           = NULL;
         queue->last_get_msg    = current_time;
         queue->esync_fd        = -1;
+        queue->shared_mapping  = NULL;
+        queue->shared          = NULL;
         list_init( &queue->send_result );
         list_init( &queue->callback_result );
         list_init( &queue->pending_timers );
@@ -438,6 +442,18 @@ void set_queue_hooks( struct thread *thread, struct hook_table *hooks )
     queue->hooks = hooks;
 }
 
+/* update the shared memory mirror of the queue bits */
+static void update_shared_queue_bits( struct msg_queue *queue )
+{
+    queue_shm_t *shared = queue->shared;
+
+    if (!shared) return;
+    SHM_WRITE_BEGIN( shared );
+    shared->wake_bits    = queue->wake_bits;
+    shared->changed_bits = queue->changed_bits;
+    SHM_WRITE_END( shared );
+}
+
 /* check the queue status */
 static inline int is_signaled( struct msg_queue *queue )
 {
@@ -449,6 +465,7 @@ static inline void set_queue_bits( struct msg_queue *queue, unsigned int bits )
 {
     queue->wake_bits |= bits;
     queue->changed_bits |= bits;
+    update_shared_queue_bits( queue );
     if (is_signaled( queue )) wake_up( &queue->obj, 0 );
 }
 
@@ -457,6 +474,7 @@ static inline void clear_queue_bits( struct msg_queue *queue, unsigned int bits
 {
     queue->wake_bits &= ~bits;
     queue->changed_bits &= ~bits;
+    update_shared_queue_bits( queue );
 
     if (do_esync() && !is_signaled( queue ))
         esync_clear( queue->esync_fd );
@@ -1010,6 +1028,7 @@ static void msg_queue_destroy( struct object *obj )
     release_object( queue->input );
     if (queue->hooks) release_object( queue->hooks );
     if (queue->fd) release_object( queue->fd );
+    if (queue->shared_mapping) free_shared_mapping( queue->shared_mapping, queue->shared );
 
     if (do_esync())
         close( queue->esync_fd );
@@ -2294,6 +2313,7 @@ DECL_HANDLER(get_queue_status)
         reply->wake_bits    = queue->wake_bits;
         reply->changed_bits = queue->changed_bits;
         queue->changed_bits &= ~req->clear_bits;
+        update_shared_queue_bits( queue );
 
         if (do_esync() && !is_signaled( queue ))
             esync_clear( queue->esync_fd );
@@ -2302,6 +2322,34 @@ DECL_HANDLER(get_queue_status)
 }
 
 
+/* get the shared memory sections mirroring the user state */
+DECL_HANDLER(get_user_shared_memory)
+{
+    const unsigned int access = SECTION_QUERY | SECTION_MAP_READ;
+    struct msg_queue *queue = current->queue;  /* don't create it, a thread without queue has no state */
+    struct desktop *desktop;
+    struct object *windows;
+
+    if (!req->queue_only)
+    {
+        if (!(windows = get_window_shared_mapping())) return;
+        if (!(desktop = get_thread_desktop( current, 0 ))) return;
+        reply->windows = alloc_handle( current->process, windows, access, 0 );
+        reply->desktop = alloc_handle( current->process, desktop->shared_mapping, access, 0 );
+        release_object( desktop );
+    }
+
+    if (!queue) return;
+    if (!queue->shared_mapping)
+    {
+        if (!(queue->shared_mapping = create_shared_mapping( sizeof(*queue->shared),
+                                                             (void **)&queue->shared ))) return;
+        update_shared_queue_bits( queue );
+    }
+    reply->queue = alloc_handle( current->process, queue->shared_mapping, access, 0 );
+}
+
+
 /* send a message to a thread queue */
 DECL_HANDLER(send_message)
 {
@@ -2472,6 +2520,7 @@ DECL_HANDLER(get_message)
     }
     if (filter & QS_INPUT) queue->changed_bits &= ~QS_INPUT;
     if (filter & QS_PAINT) queue->changed_bits &= ~QS_PAINT;
+    update_shared_queue_bits( queue );
 
     /* then check for posted messages */
     if ((filter & QS_POSTMESSAGE) &&
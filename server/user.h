@@ -76,9 +76,15 @@ struct desktop
     struct thread_input *foreground_input; /* thread input of foreground thread */
     unsigned int         users;            /* processes and threads using this desktop */
     struct global_cursor cursor;           /* global cursor information */
-    unsigned char        keystate[256];    /* asynchronous key state */
+    unsigned char       *keystate;         /* asynchronous key state, in shared memory */
+    struct object       *shared_mapping;   /* mapping for the shared desktop state */
+    desktop_shm_t       *shared;           /* shared desktop state */
 };
 
+/* updates of the shared memory mirrors; seq is odd while an update is in progress */
+#define SHM_WRITE_BEGIN(shm) interlocked_xchg_add( &(shm)->seq, 1 )
+#define SHM_WRITE_END(shm)   interlocked_xchg_add( &(shm)->seq, 1 )
+
 /* user handles functions */
 
 extern user_handle_t alloc_user_handle( void *ptr, enum user_object type );
@@ -154,6 +160,7 @@ extern void get_top_window_rectangle( struct desktop *desktop, rectangle_t *rect
 extern void post_desktop_message( struct desktop *desktop, unsigned int message,
                                   lparam_t wparam, lparam_t lparam );
 extern void destroy_window( struct window *win );
+extern struct object *get_window_shared_mapping(void);
 extern void destroy_thread_windows( struct thread *thread );
 extern int is_child_window( user_handle_t parent, user_handle_t child );
 extern int is_valid_foreground_window( user_handle_t window );
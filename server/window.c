@@ -33,6 +33,7 @@
 #include "winternl.h"
 
 #include "object.h"
+#include "file.h"
 #include "request.h"
 #include "thread.h"
 #include "process.h"
@@ -118,6 +119,11 @@ static struct window *shell_listview;
 static struct window *progman_window;
 static struct window *taskman_window;
 
+/* shared memory mirror of the window attributes, indexed by user handle */
+#define NB_SHARED_WINDOWS ((LAST_USER_HANDLE - FIRST_USER_HANDLE + 1) >> 1)
+static struct object *shared_windows_mapping;
+static window_shm_t *shared_windows;
+
 /* magic HWND_TOP etc. pointers */
 #define WINPTR_TOP       ((struct window *)1L)
 #define WINPTR_BOTTOM    ((struct window *)2L)
@@ -174,6 +180,57 @@ static inline void update_pixel_format_flags( struct window *win )
         win->paint_flags |= PAINT_PIXEL_FORMAT_CHILD;
 }
 
+/* update the shared memory mirror of a window */
+static void update_shared_window( struct window *win )
+{
+    window_shm_t *shared;
+
+    if (!shared_windows) return;
+    shared = &shared_windows[((win->handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+    SHM_WRITE_BEGIN( shared );
+    shared->handle    = win->handle;
+    shared->parent    = win->parent ? win->parent->handle : 0;
+    shared->tid       = win->thread ? get_thread_id( win->thread ) : 0;
+    shared->pid       = win->thread ? get_process_id( win->thread->process ) : 0;
+    shared->style     = win->style;
+    shared->ex_style  = win->ex_style;
+    shared->id        = win->id;
+    shared->instance  = win->instance;
+    shared->user_data = win->user_data;
+    shared->window    = win->window_rect;
+    shared->client    = win->client_rect;
+    SHM_WRITE_END( shared );
+}
+
+/* clear the shared memory mirror of a destroyed window */
+static void clear_shared_window( struct window *win )
+{
+    window_shm_t *shared;
+
+    if (!shared_windows) return;
+    shared = &shared_windows[((win->handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+    SHM_WRITE_BEGIN( shared );
+    shared->handle = 0;
+    SHM_WRITE_END( shared );
+}
+
+/* get the mapping holding the shared window table, creating it if needed */
+struct object *get_window_shared_mapping(void)
+{
+    user_handle_t handle = 0;
+    struct window *win;
+
+    if (!shared_windows_mapping)
+    {
+        if (!(shared_windows_mapping = create_shared_mapping( NB_SHARED_WINDOWS * sizeof(*shared_windows),
+                                                              (void **)&shared_windows )))
+            return NULL;
+        make_object_static( shared_windows_mapping );
+        while ((win = next_user_handle( &handle, USER_WINDOW ))) update_shared_window( win );
+    }
+    return shared_windows_mapping;
+}
+
 /* link a window at the right place in the siblings list */
 static void link_window( struct window *win, struct window *previous )
 {
@@ -263,6 +320,7 @@ static int set_parent_window( struct window *win, struct window *parent )
         list_add_head( &win->parent->unlinked, &win->entry );
         win->is_linked = 0;
     }
+    update_shared_window( win );
     return 1;
 }
 
@@ -401,6 +459,7 @@ static void detach_window_thread( struct window *win )
     /* destroyed when the desktop ref count reaches zero */
     release_object( win->desktop );
     win->thread = NULL;
+    update_shared_window( win );
 }
 
 /* get the process owning the top window of a given desktop */
@@ -527,6 +586,7 @@ static struct window *create_window( struct window *parent, struct window *owner
     }
 
     current->desktop_users++;
+    update_shared_window( win );
     return win;
 
 failed:
@@ -1670,8 +1730,10 @@ static void set_window_pos( struct window *win, struct window *previous,
             offset_rect( &child->window_rect, new_size - old_size, 0 );
             offset_rect( &child->visible_rect, new_size - old_size, 0 );
             offset_rect( &child->client_rect, new_size - old_size, 0 );
+            update_shared_window( child );
         }
     }
+    update_shared_window( win );
 
     /* reset cursor clip rectangle when the desktop changes size */
     if (win == win->desktop->top_window) win->desktop->cursor.clip = *window_rect;
@@ -1856,6 +1918,7 @@ void destroy_window( struct window *win )
     if (win == taskman_window) taskman_window = NULL;
     free_hotkeys( win->desktop, win->handle );
     cleanup_clipboard_window( win->desktop, win->handle );
+    clear_shared_window( win );
     free_user_handle( win->handle );
     destroy_properties( win );
     list_remove( &win->entry );
@@ -1967,6 +2030,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->top_window );
             desktop->top_window->style  = WS_POPUP | WS_VISIBLE | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_shared_window( desktop->top_window );
         }
     }
 
@@ -1979,6 +2043,7 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->msg_window );
             desktop->msg_window->style = WS_POPUP | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            update_shared_window( desktop->msg_window );
         }
     }
 
@@ -2086,6 +2151,7 @@ DECL_HANDLER(set_window_info)
     if (req->flags & SET_WIN_USERDATA) win->user_data = req->user_data;
     if (req->flags & SET_WIN_EXTRA) memcpy( win->extra_bytes + req->extra_offset,
                                             &req->extra_value, req->extra_size );
+    if (req->flags) update_shared_window( win );
 
     /* changing window style triggers a non-client paint */
     if (req->flags & SET_WIN_STYLE) win->paint_flags |= PAINT_NONCLIENT;
@@ -228,10 +228,17 @@ static struct desktop *create_desktop( const struct unicode_str *name, unsigned
             desktop->close_timeout = NULL;
             desktop->foreground_input = NULL;
             desktop->users = 0;
+            desktop->keystate = NULL;
             memset( &desktop->cursor, 0, sizeof(desktop->cursor) );
-            memset( desktop->keystate, 0, sizeof(desktop->keystate) );
             list_add_tail( &winstation->desktops, &desktop->entry );
             list_init( &desktop->hotkeys );
+            if (!(desktop->shared_mapping = create_shared_mapping( sizeof(*desktop->shared),
+                                                                   (void **)&desktop->shared )))
+            {
+                release_object( desktop );
+                return NULL;
+            }
+            desktop->keystate = desktop->shared->keystate;
         }
         else clear_error();
     }
@@ -293,6 +300,7 @@ static void desktop_destroy( struct object *obj )
     if (desktop->close_timeout) remove_timeout_user( desktop->close_timeout );
     list_remove( &desktop->entry );
     release_object( desktop->winstation );
+    if (desktop->shared_mapping) free_shared_mapping( desktop->shared_mapping, desktop->shared );
 }
 
 static unsigned int desktop_map_access( struct object *obj, unsigned int access )